@@ -0,0 +1,583 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "aabb_tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // traversal stack, lives on the program stack unless the tree is unusually deep
+    template<typename T>
+    class TraversalStack {
+    public:
+        void push(const T &value) {
+            if (count < INLINE_SIZE) {
+                inlineItems[count] = value;
+            } else {
+                spill.push_back(value);
+            }
+            count++;
+        }
+
+        T pop() {
+            count--;
+            if (count < INLINE_SIZE) return inlineItems[count];
+            T value = spill.back();
+            spill.pop_back();
+            return value;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+    private:
+        static const size_t INLINE_SIZE = 64;
+        T inlineItems[INLINE_SIZE];
+        std::vector<T> spill;
+        size_t count = 0;
+    };
+
+    struct RayEntry {
+        int32_t node;
+        float distance;
+    };
+
+    // true if the ray touches the box within maxDistance, distance is where it enters. a miss is reported apart from
+    // the distance so an infinite maxDistance can't let it through
+    bool rayEnter(const Aabb &box, const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance, float &distance) {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for (int axis = 0; axis < 3; axis++) {
+            float t1 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+            float t2 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+            // an axis parallel ray starting on a slab boundary gives 0 * inf, treat it as inside the slab
+            if (std::isnan(t1) || std::isnan(t2)) continue;
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+        distance = tMin;
+        return tMin <= tMax;
+    }
+
+    enum FrustumOverlap {
+        FRUSTUM_OUTSIDE,
+        FRUSTUM_INTERSECTS,
+        FRUSTUM_INSIDE
+    };
+
+    FrustumOverlap classify(const Frustum &frustum, const Aabb &box) {
+        FrustumOverlap result = FRUSTUM_INSIDE;
+        for (const glm::vec4 &plane: frustum.planes) {
+            // corners furthest along and against the plane normal
+            glm::vec3 positive(plane.x > 0.0f ? box.max.x : box.min.x, plane.y > 0.0f ? box.max.y : box.min.y, plane.z > 0.0f ? box.max.z : box.min.z);
+            glm::vec3 negative(plane.x > 0.0f ? box.min.x : box.max.x, plane.y > 0.0f ? box.min.y : box.max.y, plane.z > 0.0f ? box.min.z : box.max.z);
+            if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return FRUSTUM_OUTSIDE;
+            if (glm::dot(glm::vec3(plane), negative) + plane.w < 0.0f) result = FRUSTUM_INTERSECTS;
+        }
+        return result;
+    }
+
+    const int SAH_BINS = 16;
+}
+
+AabbTree::AabbTree(float fatMargin) : fatMargin(fatMargin) {}
+
+// NODES
+// -----
+int32_t AabbTree::allocateNode() {
+    int32_t node;
+    if (freeList != NULL_NODE) {
+        node = freeList;
+        freeList = nodes[node].parent;
+    } else {
+        node = (int32_t) nodes.size();
+        nodes.emplace_back();
+    }
+
+    Node &n = nodes[node];
+    n.parent = NULL_NODE;
+    n.child1 = NULL_NODE;
+    n.child2 = NULL_NODE;
+    n.height = 0;
+    n.userData = 0;
+    return node;
+}
+
+void AabbTree::freeNode(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void AabbTree::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    leafCount = 0;
+}
+
+// PROXIES
+// -------
+int32_t AabbTree::insert(const Aabb &bounds, uint32_t userData) {
+    int32_t leaf = allocateNode();
+    nodes[leaf].bounds = {bounds.min - glm::vec3(fatMargin), bounds.max + glm::vec3(fatMargin)};
+    nodes[leaf].userData = userData;
+    insertLeaf(leaf);
+    leafCount++;
+    return leaf;
+}
+
+void AabbTree::remove(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount--;
+}
+
+bool AabbTree::move(int32_t proxy, const Aabb &bounds, const glm::vec3 &displacement) {
+    Aabb fat = {bounds.min - glm::vec3(fatMargin), bounds.max + glm::vec3(fatMargin)};
+
+    // stretch the box along the motion so an object moving steadily isn't reinserted every frame
+    glm::vec3 stretch = displacement * 2.0f;
+    fat.min += glm::min(stretch, glm::vec3(0.0f));
+    fat.max += glm::max(stretch, glm::vec3(0.0f));
+
+    const Aabb &current = nodes[proxy].bounds;
+    if (current.contains(bounds)) {
+        // still inside, unless the fat box has grown far bigger than needed and drags down the queries
+        Aabb huge = {fat.min - glm::vec3(4.0f * fatMargin), fat.max + glm::vec3(4.0f * fatMargin)};
+        if (huge.contains(current)) return false;
+    }
+
+    removeLeaf(proxy);
+    nodes[proxy].bounds = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+void AabbTree::refit(int32_t proxy, const Aabb &bounds) {
+    nodes[proxy].bounds = {bounds.min - glm::vec3(fatMargin), bounds.max + glm::vec3(fatMargin)};
+    refitAncestors(nodes[proxy].parent, false);
+}
+
+// TREE SHAPE
+// ----------
+void AabbTree::insertLeaf(int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down towards the sibling that increases the total surface area the least. the cost of making a node the
+    // sibling is the area of the new parent, plus the growth of every ancestor on the way down
+    Aabb leafBounds = nodes[leaf].bounds;
+    int32_t index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node &node = nodes[index];
+        float area = node.bounds.halfArea();
+        float combinedArea = Aabb::merge(node.bounds, leafBounds).halfArea();
+
+        float cost = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t child) {
+            const Node &c = nodes[child];
+            float merged = Aabb::merge(c.bounds, leafBounds).halfArea();
+            return (c.isLeaf() ? merged : merged - c.bounds.halfArea()) + inheritance;
+        };
+        float cost1 = childCost(node.child1);
+        float cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t newParent = allocateNode();
+
+    Node &parent = nodes[newParent];
+    parent.parent = oldParent;
+    parent.bounds = Aabb::merge(leafBounds, nodes[sibling].bounds);
+    parent.height = nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    refitAncestors(nodes[leaf].parent, true);
+}
+
+void AabbTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    // the sibling takes the parent's place
+    if (grandParent != NULL_NODE) {
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitAncestors(grandParent, true);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void AabbTree::refitAncestors(int32_t node, bool rotate) {
+    while (node != NULL_NODE) {
+        if (rotate) node = balance(node);
+
+        Node &n = nodes[node];
+        const Node &child1 = nodes[n.child1];
+        const Node &child2 = nodes[n.child2];
+        n.height = 1 + std::max(child1.height, child2.height);
+        n.bounds = Aabb::merge(child1.bounds, child2.bounds);
+
+        node = n.parent;
+    }
+}
+
+// a has children b and c. if one of them is more than one level taller it is rotated up to take a's place, and a takes
+// its shorter child. returns the subtree's new root
+int32_t AabbTree::balance(int32_t a) {
+    Node &nodeA = nodes[a];
+    if (nodeA.isLeaf() || nodeA.height < 2) return a;
+
+    int32_t b = nodeA.child1;
+    int32_t c = nodeA.child2;
+    int32_t difference = nodes[c].height - nodes[b].height;
+
+    // rotate c up
+    if (difference > 1) {
+        Node &nodeC = nodes[c];
+        int32_t f = nodeC.child1;
+        int32_t g = nodeC.child2;
+
+        nodeC.child1 = a;
+        nodeC.parent = nodeA.parent;
+        nodeA.parent = c;
+
+        if (nodeC.parent != NULL_NODE) {
+            if (nodes[nodeC.parent].child1 == a) {
+                nodes[nodeC.parent].child1 = c;
+            } else {
+                nodes[nodeC.parent].child2 = c;
+            }
+        } else {
+            root = c;
+        }
+
+        // the shorter of c's children moves under a
+        int32_t keep = nodes[f].height > nodes[g].height ? f : g;
+        int32_t give = keep == f ? g : f;
+        nodeC.child2 = keep;
+        nodeA.child2 = give;
+        nodes[give].parent = a;
+
+        nodeA.bounds = Aabb::merge(nodes[b].bounds, nodes[give].bounds);
+        nodeC.bounds = Aabb::merge(nodeA.bounds, nodes[keep].bounds);
+        nodeA.height = 1 + std::max(nodes[b].height, nodes[give].height);
+        nodeC.height = 1 + std::max(nodeA.height, nodes[keep].height);
+        return c;
+    }
+
+    // rotate b up
+    if (difference < -1) {
+        Node &nodeB = nodes[b];
+        int32_t d = nodeB.child1;
+        int32_t e = nodeB.child2;
+
+        nodeB.child1 = a;
+        nodeB.parent = nodeA.parent;
+        nodeA.parent = b;
+
+        if (nodeB.parent != NULL_NODE) {
+            if (nodes[nodeB.parent].child1 == a) {
+                nodes[nodeB.parent].child1 = b;
+            } else {
+                nodes[nodeB.parent].child2 = b;
+            }
+        } else {
+            root = b;
+        }
+
+        int32_t keep = nodes[d].height > nodes[e].height ? d : e;
+        int32_t give = keep == d ? e : d;
+        nodeB.child2 = keep;
+        nodeA.child1 = give;
+        nodes[give].parent = a;
+
+        nodeA.bounds = Aabb::merge(nodes[c].bounds, nodes[give].bounds);
+        nodeB.bounds = Aabb::merge(nodeA.bounds, nodes[keep].bounds);
+        nodeA.height = 1 + std::max(nodes[c].height, nodes[give].height);
+        nodeB.height = 1 + std::max(nodeA.height, nodes[keep].height);
+        return b;
+    }
+
+    return a;
+}
+
+// REBUILD
+// -------
+void AabbTree::rebuild() {
+    std::vector<int32_t> leaves;
+    leaves.reserve(leafCount);
+
+    for (int32_t i = 0; i < (int32_t) nodes.size(); i++) {
+        if (nodes[i].height < 0) continue;
+        if (nodes[i].isLeaf()) {
+            leaves.push_back(i);
+        } else {
+            freeNode(i);
+        }
+    }
+
+    root = leaves.empty() ? NULL_NODE : buildRange(leaves.data(), leaves.size());
+    if (root != NULL_NODE) nodes[root].parent = NULL_NODE;
+}
+
+// splits the leaves along the longest axis of their centers at the binned split with the lowest surface area cost
+int32_t AabbTree::buildRange(int32_t *leaves, size_t count) {
+    if (count == 1) return leaves[0];
+
+    Aabb centers = {nodes[leaves[0]].bounds.center(), nodes[leaves[0]].bounds.center()};
+    for (size_t i = 1; i < count; i++) {
+        glm::vec3 center = nodes[leaves[i]].bounds.center();
+        centers.min = glm::min(centers.min, center);
+        centers.max = glm::max(centers.max, center);
+    }
+
+    glm::vec3 extent = centers.max - centers.min;
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+    size_t split = count / 2;
+    if (extent[axis] > 0.0f) {
+        float binScale = (float) SAH_BINS / extent[axis];
+        auto binOf = [&](int32_t leaf) {
+            int bin = (int) ((nodes[leaf].bounds.center()[axis] - centers.min[axis]) * binScale);
+            return std::min(bin, SAH_BINS - 1);
+        };
+
+        Aabb binBounds[SAH_BINS];
+        size_t binCounts[SAH_BINS] = {};
+        for (size_t i = 0; i < count; i++) {
+            int bin = binOf(leaves[i]);
+            binBounds[bin] = binCounts[bin] ? Aabb::merge(binBounds[bin], nodes[leaves[i]].bounds) : nodes[leaves[i]].bounds;
+            binCounts[bin]++;
+        }
+
+        // sweep from the right to get the cost of everything past each plane, then from the left to pick the best
+        float rightCosts[SAH_BINS] = {};
+        Aabb sweep{};
+        size_t sweepCount = 0;
+        for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+            if (binCounts[bin]) {
+                sweep = sweepCount ? Aabb::merge(sweep, binBounds[bin]) : binBounds[bin];
+                sweepCount += binCounts[bin];
+            }
+            rightCosts[bin] = sweepCount ? sweep.halfArea() * (float) sweepCount : 0.0f;
+        }
+
+        float bestCost = std::numeric_limits<float>::max();
+        int bestBin = -1;
+        sweepCount = 0;
+        for (int bin = 0; bin < SAH_BINS - 1; bin++) {
+            if (binCounts[bin]) {
+                sweep = sweepCount ? Aabb::merge(sweep, binBounds[bin]) : binBounds[bin];
+                sweepCount += binCounts[bin];
+            }
+            if (sweepCount == 0 || sweepCount == count) continue;
+
+            float cost = sweep.halfArea() * (float) sweepCount + rightCosts[bin + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestBin = bin;
+            }
+        }
+
+        if (bestBin >= 0) {
+            split = (size_t) (std::partition(leaves, leaves + count, [&](int32_t leaf) { return binOf(leaf) <= bestBin; }) - leaves);
+        }
+    }
+
+    // every center in one bin, fall back to splitting at the median
+    if (split == 0 || split == count || extent[axis] <= 0.0f) {
+        split = count / 2;
+        std::nth_element(leaves, leaves + split, leaves + count, [&](int32_t l, int32_t r) {
+            return nodes[l].bounds.center()[axis] < nodes[r].bounds.center()[axis];
+        });
+    }
+
+    int32_t node = allocateNode();
+    int32_t child1 = buildRange(leaves, split);
+    int32_t child2 = buildRange(leaves + split, count - split);
+
+    Node &n = nodes[node];
+    n.child1 = child1;
+    n.child2 = child2;
+    n.bounds = Aabb::merge(nodes[child1].bounds, nodes[child2].bounds);
+    n.height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+    nodes[child1].parent = node;
+    nodes[child2].parent = node;
+    return node;
+}
+
+float AabbTree::getAreaRatio() const {
+    if (root == NULL_NODE) return 0.0f;
+
+    float total = 0.0f;
+    for (const Node &node: nodes) {
+        if (node.height > 0) total += node.bounds.halfArea();
+    }
+
+    float rootArea = nodes[root].bounds.halfArea();
+    return rootArea > 0.0f ? total / rootArea : 0.0f;
+}
+
+// QUERIES
+// -------
+void AabbTree::queryFrustum(const Frustum &frustum, std::vector<uint32_t> &results) const {
+    if (root == NULL_NODE) return;
+
+    // nodes entirely inside the frustum report their whole subtree without testing it
+    TraversalStack<int32_t> stack;
+    TraversalStack<int32_t> inside;
+    stack.push(root);
+
+    while (!stack.empty()) {
+        int32_t index = stack.pop();
+        const Node &node = nodes[index];
+
+        FrustumOverlap overlap = classify(frustum, node.bounds);
+        if (overlap == FRUSTUM_OUTSIDE) continue;
+
+        if (node.isLeaf()) {
+            results.push_back(node.userData);
+        } else if (overlap == FRUSTUM_INSIDE) {
+            inside.push(index);
+            while (!inside.empty()) {
+                const Node &subtree = nodes[inside.pop()];
+                if (subtree.isLeaf()) {
+                    results.push_back(subtree.userData);
+                } else {
+                    inside.push(subtree.child1);
+                    inside.push(subtree.child2);
+                }
+            }
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+void AabbTree::querySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results) const {
+    if (root == NULL_NODE) return;
+
+    float radiusSquared = radius * radius;
+    TraversalStack<int32_t> stack;
+    stack.push(root);
+
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.pop()];
+
+        glm::vec3 closest = glm::clamp(center, node.bounds.min, node.bounds.max);
+        glm::vec3 offset = center - closest;
+        if (glm::dot(offset, offset) > radiusSquared) continue;
+
+        if (node.isLeaf()) {
+            results.push_back(node.userData);
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+void AabbTree::queryAabb(const Aabb &bounds, std::vector<uint32_t> &results) const {
+    if (root == NULL_NODE) return;
+
+    TraversalStack<int32_t> stack;
+    stack.push(root);
+
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.pop()];
+        if (!node.bounds.overlaps(bounds)) continue;
+
+        if (node.isLeaf()) {
+            results.push_back(node.userData);
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+void AabbTree::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                       const std::function<float(uint32_t, float)> &hit) const {
+    if (root == NULL_NODE) return;
+
+    glm::vec3 inverseDirection = glm::vec3(1.0f) / direction;
+
+    float rootDistance = 0.0f;
+    if (!rayEnter(nodes[root].bounds, origin, inverseDirection, maxDistance, rootDistance)) return;
+
+    TraversalStack<RayEntry> stack;
+    stack.push({root, rootDistance});
+
+    while (!stack.empty()) {
+        RayEntry entry = stack.pop();
+
+        // the search may have been shortened since this node was pushed
+        if (entry.distance > maxDistance) continue;
+
+        const Node &node = nodes[entry.node];
+        if (node.isLeaf()) {
+            maxDistance = hit(node.userData, entry.distance);
+            if (maxDistance <= 0.0f) return;
+            continue;
+        }
+
+        RayEntry first = {node.child1, 0.0f};
+        RayEntry second = {node.child2, 0.0f};
+        bool firstHit = rayEnter(nodes[node.child1].bounds, origin, inverseDirection, maxDistance, first.distance);
+        bool secondHit = rayEnter(nodes[node.child2].bounds, origin, inverseDirection, maxDistance, second.distance);
+        if (firstHit && secondHit && second.distance < first.distance) std::swap(first, second);
+
+        // push the far child first so the near one is visited first
+        if (firstHit && secondHit) {
+            stack.push(second);
+            stack.push(first);
+        } else if (firstHit) {
+            stack.push(first);
+        } else if (secondHit) {
+            stack.push(second);
+        }
+    }
+}
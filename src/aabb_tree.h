@@ -0,0 +1,137 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_AABB_TREE_H
+#define KIRA_SOURCE_AABB_TREE_H
+
+#include <glm/glm.hpp>
+
+#include "culling.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct Aabb {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    glm::vec3 center() const {
+        return (min + max) * 0.5f;
+    }
+
+    // half the surface area, only ever compared so the factor of 2 is left out
+    float halfArea() const {
+        glm::vec3 size = max - min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    bool contains(const Aabb &other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    bool overlaps(const Aabb &other) const {
+        return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+               max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+    }
+
+    static Aabb merge(const Aabb &a, const Aabb &b) {
+        return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+};
+
+// dynamic bounding volume hierarchy over the scene's objects. leaves store an enlarged ("fat") box so objects that
+// move a little don't touch the tree, nodes live in one flat array and are recycled through a free list.
+// proxies returned by insert stay valid until remove, even across rebuild
+class AabbTree {
+public:
+    static const int32_t NULL_NODE = -1;
+
+    // margin added on every side of a leaf's box
+    explicit AabbTree(float fatMargin = 0.1f);
+
+    // adds an object and returns its proxy, userData is what the queries report for it
+    int32_t insert(const Aabb &bounds, uint32_t userData);
+    void remove(int32_t proxy);
+
+    // reinserts the object if its new box left the fat box, returns true if it did. displacement is how far the object
+    // moved since the last call, the fat box is stretched along it to predict the next move
+    bool move(int32_t proxy, const Aabb &bounds, const glm::vec3 &displacement = glm::vec3(0.0f));
+
+    // replaces a leaf's box in place and refits its ancestors without changing the tree's shape. cheaper than move for
+    // small changes, but the tree degrades if boxes drift far so rebuild every so often
+    void refit(int32_t proxy, const Aabb &bounds);
+
+    // throws away every internal node and builds the tree again top down, splitting with the surface area heuristic
+    void rebuild();
+
+    void clear();
+
+    uint32_t getUserData(int32_t proxy) const {
+        return nodes[proxy].userData;
+    }
+
+    const Aabb &getFatBounds(int32_t proxy) const {
+        return nodes[proxy].bounds;
+    }
+
+    size_t getLeafCount() const {
+        return leafCount;
+    }
+
+    // longest path from the root to a leaf, 0 for an empty tree
+    int getHeight() const {
+        return root == NULL_NODE ? 0 : nodes[root].height + 1;
+    }
+
+    // sum of the internal nodes' surface areas relative to the root's, lower is a better tree
+    float getAreaRatio() const;
+
+    // the queries append the userData of every leaf whose fat box passes the test, in no particular order
+    void queryFrustum(const Frustum &frustum, std::vector<uint32_t> &results) const;
+    void querySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results) const;
+    void queryAabb(const Aabb &bounds, std::vector<uint32_t> &results) const;
+
+    // walks the leaves the ray passes through, nearest subtree first. hit receives the userData and the distance the
+    // ray enters the fat box and returns the distance the search is limited to from then on: return the exact hit
+    // distance to find the closest object, maxDistance to keep going, or 0 to stop
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                 const std::function<float(uint32_t userData, float distance)> &hit) const;
+
+private:
+    struct Node {
+        Aabb bounds;
+        int32_t parent;  // next free node while the node is on the free list
+        int32_t child1;
+        int32_t child2;
+        int32_t height;  // 0 for leaves, -1 for free nodes
+        uint32_t userData;
+
+        bool isLeaf() const {
+            return child1 == NULL_NODE;
+        }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    size_t leafCount = 0;
+    float fatMargin;
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+
+    // recomputes bounds and heights from node up to the root, rotating where the tree got unbalanced
+    void refitAncestors(int32_t node, bool rotate);
+    int32_t balance(int32_t node);
+
+    int32_t buildRange(int32_t *leaves, size_t count);
+};
+
+#endif //KIRA_SOURCE_AABB_TREE_H
@@ -0,0 +1,247 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "clustered_lighting.h"
+#include "job_system.h"
+#include "includes/GL_STATE_CACHE.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KIRA_CLUSTERS_SSE
+#endif
+
+float lightRange(const PointLight &light) {
+    glm::vec3 brightest = glm::max(light.ambient, glm::max(light.diffuse, light.specular));
+    float intensity = std::max(brightest.x, std::max(brightest.y, brightest.z));
+
+    // solve constant + linear * d + quadratic * d^2 = intensity * 256
+    float target = intensity * 256.0f - light.constant;
+    if (target <= 0.0f) return 0.0f;
+    if (light.quadratic > 0.0f) {
+        return (-light.linear + std::sqrt(light.linear * light.linear + 4.0f * light.quadratic * target)) / (2.0f * light.quadratic);
+    }
+    if (light.linear > 0.0f) return target / light.linear;
+
+    // no falloff, the light reaches every cluster
+    return FLT_MAX;
+}
+
+// CLUSTER ASSIGNMENT
+// ------------------
+LightClusters::LightClusters() {
+    size_t boundsSize = (size_t) SLICE_STRIDE * CLUSTER_GRID_Z;
+    minX.resize(boundsSize);
+    minY.resize(boundsSize);
+    minZ.resize(boundsSize);
+    maxX.resize(boundsSize);
+    maxY.resize(boundsSize);
+    maxZ.resize(boundsSize);
+
+    clusterCounts.resize(CLUSTER_COUNT);
+    clusterLists.resize((size_t) CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER);
+    clusterRanges.resize((size_t) CLUSTER_COUNT * 2);
+}
+
+void LightClusters::updateBounds(const glm::mat4 &projection, float zNear, float zFar) {
+    if (projection == boundsProjection && zNear == boundsNear && zFar == boundsFar) return;
+
+    boundsProjection = projection;
+    boundsNear = zNear;
+    boundsFar = zFar;
+
+    // a point at ndc (x, y) and view distance d sits at (x * d / p00, y * d / p11, -d) for a symmetric perspective
+    float inverseX = 1.0f / projection[0][0];
+    float inverseY = 1.0f / projection[1][1];
+
+    for (unsigned int z = 0; z < CLUSTER_GRID_Z; z++) {
+        float sliceNear = zNear * std::pow(zFar / zNear, (float) z / CLUSTER_GRID_Z);
+        float sliceFar = zNear * std::pow(zFar / zNear, (float) (z + 1) / CLUSTER_GRID_Z);
+
+        for (unsigned int i = 0; i < SLICE_STRIDE; i++) {
+            size_t bound = (size_t) z * SLICE_STRIDE + i;
+
+            // padding clusters get inverted bounds so no sphere ever touches them
+            if (i >= CLUSTER_GRID_X * CLUSTER_GRID_Y) {
+                minX[bound] = minY[bound] = minZ[bound] = FLT_MAX;
+                maxX[bound] = maxY[bound] = maxZ[bound] = -FLT_MAX;
+                continue;
+            }
+
+            unsigned int x = i % CLUSTER_GRID_X;
+            unsigned int y = i / CLUSTER_GRID_X;
+            float ndcX0 = -1.0f + 2.0f * (float) x / CLUSTER_GRID_X;
+            float ndcX1 = -1.0f + 2.0f * (float) (x + 1) / CLUSTER_GRID_X;
+            float ndcY0 = -1.0f + 2.0f * (float) y / CLUSTER_GRID_Y;
+            float ndcY1 = -1.0f + 2.0f * (float) (y + 1) / CLUSTER_GRID_Y;
+
+            float xs[4] = {ndcX0 * sliceNear * inverseX, ndcX1 * sliceNear * inverseX, ndcX0 * sliceFar * inverseX, ndcX1 * sliceFar * inverseX};
+            float ys[4] = {ndcY0 * sliceNear * inverseY, ndcY1 * sliceNear * inverseY, ndcY0 * sliceFar * inverseY, ndcY1 * sliceFar * inverseY};
+
+            minX[bound] = *std::min_element(xs, xs + 4);
+            maxX[bound] = *std::max_element(xs, xs + 4);
+            minY[bound] = *std::min_element(ys, ys + 4);
+            maxY[bound] = *std::max_element(ys, ys + 4);
+            minZ[bound] = -sliceFar;
+            maxZ[bound] = -sliceNear;
+        }
+    }
+}
+
+void LightClusters::assignSlice(unsigned int slice, float zNear, float zFar) {
+    float sliceNear = zNear * std::pow(zFar / zNear, (float) slice / CLUSTER_GRID_Z);
+    float sliceFar = zNear * std::pow(zFar / zNear, (float) (slice + 1) / CLUSTER_GRID_Z);
+
+    size_t sliceBase = (size_t) slice * SLICE_STRIDE;
+    uint32_t *counts = &clusterCounts[(size_t) slice * CLUSTER_GRID_X * CLUSTER_GRID_Y];
+    std::fill(counts, counts + CLUSTER_GRID_X * CLUSTER_GRID_Y, 0);
+
+    for (size_t lightIndex = 0; lightIndex < viewLights.size(); lightIndex++) {
+        const glm::vec4 &light = viewLights[lightIndex];
+
+        // skip lights whose depth range misses this slice entirely
+        float depth = -light.z;
+        if (depth + light.w < sliceNear || depth - light.w > sliceFar) continue;
+
+#ifdef KIRA_CLUSTERS_SSE
+        const __m128 centerX = _mm_set1_ps(light.x);
+        const __m128 centerY = _mm_set1_ps(light.y);
+        const __m128 centerZ = _mm_set1_ps(light.z);
+        const __m128 radiusSquared = _mm_set1_ps(light.w * light.w);
+        const __m128 zero = _mm_setzero_ps();
+
+        // sphere against 4 cluster boxes at a time, squared distance from the center to each box
+        for (unsigned int i = 0; i < SLICE_STRIDE; i += 4) {
+            size_t bound = sliceBase + i;
+            __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minX[bound]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&maxX[bound]))), zero);
+            __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minY[bound]), centerY), _mm_sub_ps(centerY, _mm_loadu_ps(&maxY[bound]))), zero);
+            __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minZ[bound]), centerZ), _mm_sub_ps(centerZ, _mm_loadu_ps(&maxZ[bound]))), zero);
+            __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+            int hits = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared));
+            while (hits) {
+                unsigned int lane = 0;
+                while (!(hits & (1 << lane))) lane++;
+                hits &= ~(1 << lane);
+
+                unsigned int cluster = i + lane;
+                if (counts[cluster] < MAX_LIGHTS_PER_CLUSTER) {
+                    size_t globalCluster = (size_t) slice * CLUSTER_GRID_X * CLUSTER_GRID_Y + cluster;
+                    clusterLists[globalCluster * MAX_LIGHTS_PER_CLUSTER + counts[cluster]++] = visibleLights[lightIndex];
+                }
+            }
+        }
+#else
+        for (unsigned int cluster = 0; cluster < CLUSTER_GRID_X * CLUSTER_GRID_Y; cluster++) {
+            size_t bound = sliceBase + cluster;
+            float dx = std::max(std::max(minX[bound] - light.x, light.x - maxX[bound]), 0.0f);
+            float dy = std::max(std::max(minY[bound] - light.y, light.y - maxY[bound]), 0.0f);
+            float dz = std::max(std::max(minZ[bound] - light.z, light.z - maxZ[bound]), 0.0f);
+            if (dx * dx + dy * dy + dz * dz > light.w * light.w) continue;
+
+            if (counts[cluster] < MAX_LIGHTS_PER_CLUSTER) {
+                size_t globalCluster = (size_t) slice * CLUSTER_GRID_X * CLUSTER_GRID_Y + cluster;
+                clusterLists[globalCluster * MAX_LIGHTS_PER_CLUSTER + counts[cluster]++] = visibleLights[lightIndex];
+            }
+        }
+#endif
+    }
+}
+
+void LightClusters::build(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection, float zNear, float zFar) {
+    updateBounds(projection, zNear, zFar);
+
+    lightSpheres.clear();
+    for (const PointLight &light: lights) lightSpheres.add(light.position, lightRange(light));
+    cullSpheres(extractFrustum(projection * view), lightSpheres, visibleLights);
+
+    viewLights.resize(visibleLights.size());
+    for (size_t i = 0; i < visibleLights.size(); i++) {
+        uint32_t light = visibleLights[i];
+        glm::vec4 center = view * glm::vec4(lights[light].position, 1.0f);
+        viewLights[i] = glm::vec4(center.x, center.y, center.z, lightSpheres.radius[light]);
+    }
+
+    // each slice owns its clusters, so slices can be filled on separate threads without locking
+    ThreadPool::global().parallelFor(CLUSTER_GRID_Z, 1, [this, zNear, zFar](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; slice++) assignSlice((unsigned int) slice, zNear, zFar);
+    });
+
+    // compact the fixed size lists into one index array
+    lightIndices.clear();
+    for (unsigned int cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        clusterRanges[cluster * 2] = (uint32_t) lightIndices.size();
+        clusterRanges[cluster * 2 + 1] = clusterCounts[cluster];
+
+        const uint32_t *list = &clusterLists[(size_t) cluster * MAX_LIGHTS_PER_CLUSTER];
+        lightIndices.insert(lightIndices.end(), list, list + clusterCounts[cluster]);
+    }
+}
+
+// GPU BUFFERS
+// -----------
+ClusteredLightBuffers::ClusteredLightBuffers() {
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+
+    const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    for (int i = 0; i < 3; i++) {
+        // texture buffers need some storage before they are sampled
+        glState().bindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_DYNAMIC_DRAW);
+
+        glState().bindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+}
+
+ClusteredLightBuffers::~ClusteredLightBuffers() {
+    glState().deleteTextures(3, textures);
+    glState().deleteBuffers(3, buffers);
+}
+
+void ClusteredLightBuffers::uploadLights(const std::vector<PointLight> &lights) {
+    // four texels per light, see fetchPointLight in the shader
+    std::vector<glm::vec4> texels;
+    texels.reserve(lights.size() * 4 + 1);
+    for (const PointLight &light: lights) {
+        texels.emplace_back(light.position, lightRange(light));
+        texels.emplace_back(light.ambient, light.constant);
+        texels.emplace_back(light.diffuse, light.linear);
+        texels.emplace_back(light.specular, light.quadratic);
+    }
+    if (texels.empty()) texels.emplace_back(0.0f);
+
+    glState().bindBuffer(GL_TEXTURE_BUFFER, buffers[0]);
+    glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr) (texels.size() * sizeof(glm::vec4)), texels.data(), GL_STATIC_DRAW);
+}
+
+void ClusteredLightBuffers::uploadClusters(const LightClusters &clusters) {
+    const std::vector<uint32_t> &ranges = clusters.getClusterRanges();
+    const std::vector<uint32_t> &indices = clusters.getLightIndices();
+    uint32_t empty = 0;
+
+    // orphan the old storage so the driver doesn't wait for last frame's draws
+    glState().bindBuffer(GL_TEXTURE_BUFFER, buffers[1]);
+    glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr) (ranges.size() * sizeof(uint32_t)), ranges.data(), GL_STREAM_DRAW);
+
+    glState().bindBuffer(GL_TEXTURE_BUFFER, buffers[2]);
+    if (indices.empty()) {
+        glBufferData(GL_TEXTURE_BUFFER, sizeof(empty), &empty, GL_STREAM_DRAW);
+    } else {
+        glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr) (indices.size() * sizeof(uint32_t)), indices.data(), GL_STREAM_DRAW);
+    }
+}
+
+void ClusteredLightBuffers::bind() const {
+    const unsigned int units[3] = {LIGHT_DATA_TEXTURE_UNIT, CLUSTER_RANGES_TEXTURE_UNIT, LIGHT_INDICES_TEXTURE_UNIT};
+    for (int i = 0; i < 3; i++) {
+        glState().bindTexture(units[i], GL_TEXTURE_BUFFER, textures[i]);
+    }
+}
@@ -0,0 +1,109 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_CLUSTERED_LIGHTING_H
+#define KIRA_SOURCE_CLUSTERED_LIGHTING_H
+
+#include <glm/glm.hpp>
+
+#include "culling.h"
+
+#include <cstdint>
+#include <vector>
+
+// the view frustum is split into a grid of clusters, tiles in screen space and exponential slices in depth
+const unsigned int CLUSTER_GRID_X = 16;
+const unsigned int CLUSTER_GRID_Y = 9;
+const unsigned int CLUSTER_GRID_Z = 24;
+const unsigned int CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+// lights past this count in a single cluster are dropped
+const unsigned int MAX_LIGHTS_PER_CLUSTER = 128;
+
+// texture units of the light buffers, these must match the layout(binding = N) in shaders/common/clustered_lighting.glsl
+const unsigned int LIGHT_DATA_TEXTURE_UNIT = 4;
+const unsigned int CLUSTER_RANGES_TEXTURE_UNIT = 5;
+const unsigned int LIGHT_INDICES_TEXTURE_UNIT = 6;
+
+struct PointLight {
+    glm::vec3 position;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+// distance at which a light's attenuated contribution falls below 1/256, used as its culling radius
+float lightRange(const PointLight &light);
+
+// builds the per-cluster light lists on the cpu, every frame the camera or lights move
+class LightClusters {
+public:
+    LightClusters();
+
+    // assigns every light to the clusters its range sphere touches, slices are processed in parallel on the thread pool.
+    // lights whose sphere misses the view frustum are dropped first
+    void build(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection, float zNear, float zFar);
+
+    // (offset, count) into the light indices for every cluster
+    const std::vector<uint32_t> &getClusterRanges() const {
+        return clusterRanges;
+    }
+
+    const std::vector<uint32_t> &getLightIndices() const {
+        return lightIndices;
+    }
+
+private:
+    // view space cluster bounds, one structure of arrays block per slice padded to a multiple of 4 clusters
+    static constexpr unsigned int SLICE_STRIDE = (CLUSTER_GRID_X * CLUSTER_GRID_Y + 3) & ~3u;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    glm::mat4 boundsProjection = glm::mat4(0.0f);
+    float boundsNear = 0.0f;
+    float boundsFar = 0.0f;
+
+    // world space range spheres of every light, and the ones in the frustum
+    BoundingSpheres lightSpheres;
+    std::vector<uint32_t> visibleLights;
+
+    // centers of the visible lights in view space with the range in w, in the order of visibleLights
+    std::vector<glm::vec4> viewLights;
+
+    std::vector<uint32_t> clusterCounts;
+    std::vector<uint32_t> clusterLists;
+
+    std::vector<uint32_t> clusterRanges;
+    std::vector<uint32_t> lightIndices;
+
+    void updateBounds(const glm::mat4 &projection, float zNear, float zFar);
+    void assignSlice(unsigned int slice, float zNear, float zFar);
+};
+
+// gpu copies of the lights and cluster lists, stored in texture buffers
+class ClusteredLightBuffers {
+public:
+    ClusteredLightBuffers();
+
+    ClusteredLightBuffers(const ClusteredLightBuffers &) = delete;
+    ClusteredLightBuffers &operator=(const ClusteredLightBuffers &) = delete;
+
+    ~ClusteredLightBuffers();
+
+    // only needed when lights are added, removed or changed
+    void uploadLights(const std::vector<PointLight> &lights);
+
+    void uploadClusters(const LightClusters &clusters);
+
+    // binds the three texture buffers to their fixed units
+    void bind() const;
+
+private:
+    unsigned int buffers[3] = {};
+    unsigned int textures[3] = {};
+};
+
+#endif //KIRA_SOURCE_CLUSTERED_LIGHTING_H
@@ -0,0 +1,233 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "culling.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define KIRA_CULLING_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KIRA_CULLING_SSE
+#endif
+
+Frustum extractFrustum(const glm::mat4 &viewProjection) {
+    // glm is column major, row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&viewProjection](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    Frustum frustum;
+    frustum.planes[0] = row(3) + row(0);
+    frustum.planes[1] = row(3) - row(0);
+    frustum.planes[2] = row(3) + row(1);
+    frustum.planes[3] = row(3) - row(1);
+    frustum.planes[4] = row(3) + row(2);
+    frustum.planes[5] = row(3) - row(2);
+
+    for (glm::vec4 &plane: frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return frustum;
+}
+
+// BOUNDS
+// ------
+size_t BoundingSpheres::add(const glm::vec3 &center, float sphereRadius) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(sphereRadius);
+    return radius.size() - 1;
+}
+
+void BoundingSpheres::set(size_t index, const glm::vec3 &center, float sphereRadius) {
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    radius[index] = sphereRadius;
+}
+
+void BoundingSpheres::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+size_t BoundingBoxes::add(const glm::vec3 &minimum, const glm::vec3 &maximum) {
+    minX.push_back(minimum.x);
+    minY.push_back(minimum.y);
+    minZ.push_back(minimum.z);
+    maxX.push_back(maximum.x);
+    maxY.push_back(maximum.y);
+    maxZ.push_back(maximum.z);
+    return minX.size() - 1;
+}
+
+void BoundingBoxes::set(size_t index, const glm::vec3 &minimum, const glm::vec3 &maximum) {
+    minX[index] = minimum.x;
+    minY[index] = minimum.y;
+    minZ[index] = minimum.z;
+    maxX[index] = maximum.x;
+    maxY[index] = maximum.y;
+    maxZ[index] = maximum.z;
+}
+
+void BoundingBoxes::clear() {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+// SCALAR TESTS
+// ------------
+namespace {
+    bool sphereVisible(const Frustum &frustum, float x, float y, float z, float radius) {
+        for (const glm::vec4 &plane: frustum.planes) {
+            if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    // only the corner furthest along the plane normal needs testing, if that one is outside the whole box is
+    bool boxVisible(const Frustum &frustum, const BoundingBoxes &boxes, size_t i) {
+        for (const glm::vec4 &plane: frustum.planes) {
+            float x = plane.x > 0.0f ? boxes.maxX[i] : boxes.minX[i];
+            float y = plane.y > 0.0f ? boxes.maxY[i] : boxes.minY[i];
+            float z = plane.z > 0.0f ? boxes.maxZ[i] : boxes.minZ[i];
+            if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    // appends the set lanes of a visibility mask as object indices
+    size_t appendVisible(unsigned int mask, size_t base, uint32_t *out) {
+        size_t written = 0;
+        while (mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            int lane = __builtin_ctz(mask);
+#else
+            int lane = 0;
+            while (!((mask >> lane) & 1u)) lane++;
+#endif
+            out[written++] = (uint32_t) (base + lane);
+            mask &= mask - 1;
+        }
+        return written;
+    }
+}
+
+// SIMD TESTS
+// ----------
+// the planes are the same for every lane, so picking the box corner per plane is a scalar choice of array rather than
+// a per-lane blend
+#if defined(KIRA_CULLING_AVX)
+static const size_t CULL_LANES = 8;
+
+static unsigned int spheresVisibleMask(const Frustum &frustum, const BoundingSpheres &spheres, size_t i) {
+    __m256 x = _mm256_loadu_ps(&spheres.centerX[i]);
+    __m256 y = _mm256_loadu_ps(&spheres.centerY[i]);
+    __m256 z = _mm256_loadu_ps(&spheres.centerZ[i]);
+    __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+    __m256 outside = _mm256_setzero_ps();
+    for (const glm::vec4 &plane: frustum.planes) {
+        __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x), _mm256_mul_ps(_mm256_set1_ps(plane.y), y)),
+                                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), z), _mm256_set1_ps(plane.w)));
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negativeRadius, _CMP_LT_OQ));
+    }
+    return ~(unsigned int) _mm256_movemask_ps(outside) & 0xFFu;
+}
+
+static unsigned int boxesVisibleMask(const Frustum &frustum, const BoundingBoxes &boxes, size_t i) {
+    __m256 outside = _mm256_setzero_ps();
+    for (const glm::vec4 &plane: frustum.planes) {
+        __m256 x = _mm256_loadu_ps(plane.x > 0.0f ? &boxes.maxX[i] : &boxes.minX[i]);
+        __m256 y = _mm256_loadu_ps(plane.y > 0.0f ? &boxes.maxY[i] : &boxes.minY[i]);
+        __m256 z = _mm256_loadu_ps(plane.z > 0.0f ? &boxes.maxZ[i] : &boxes.minZ[i]);
+        __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x), _mm256_mul_ps(_mm256_set1_ps(plane.y), y)),
+                                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), z), _mm256_set1_ps(plane.w)));
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+    return ~(unsigned int) _mm256_movemask_ps(outside) & 0xFFu;
+}
+#elif defined(KIRA_CULLING_SSE)
+static const size_t CULL_LANES = 4;
+
+static unsigned int spheresVisibleMask(const Frustum &frustum, const BoundingSpheres &spheres, size_t i) {
+    __m128 x = _mm_loadu_ps(&spheres.centerX[i]);
+    __m128 y = _mm_loadu_ps(&spheres.centerY[i]);
+    __m128 z = _mm_loadu_ps(&spheres.centerZ[i]);
+    __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+    __m128 outside = _mm_setzero_ps();
+    for (const glm::vec4 &plane: frustum.planes) {
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z), _mm_set1_ps(plane.w)));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+    }
+    return ~(unsigned int) _mm_movemask_ps(outside) & 0xFu;
+}
+
+static unsigned int boxesVisibleMask(const Frustum &frustum, const BoundingBoxes &boxes, size_t i) {
+    __m128 outside = _mm_setzero_ps();
+    for (const glm::vec4 &plane: frustum.planes) {
+        __m128 x = _mm_loadu_ps(plane.x > 0.0f ? &boxes.maxX[i] : &boxes.minX[i]);
+        __m128 y = _mm_loadu_ps(plane.y > 0.0f ? &boxes.maxY[i] : &boxes.minY[i]);
+        __m128 z = _mm_loadu_ps(plane.z > 0.0f ? &boxes.maxZ[i] : &boxes.minZ[i]);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z), _mm_set1_ps(plane.w)));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+    }
+    return ~(unsigned int) _mm_movemask_ps(outside) & 0xFu;
+}
+#endif
+
+size_t cullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, std::vector<uint32_t> &visible) {
+    size_t count = spheres.size();
+    visible.resize(count);
+    size_t written = 0;
+    size_t i = 0;
+
+#if defined(KIRA_CULLING_AVX) || defined(KIRA_CULLING_SSE)
+    for (; i + CULL_LANES <= count; i += CULL_LANES) {
+        written += appendVisible(spheresVisibleMask(frustum, spheres, i), i, &visible[written]);
+    }
+#endif
+
+    // remainder that doesn't fill a full register
+    for (; i < count; i++) {
+        if (sphereVisible(frustum, spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i], spheres.radius[i])) visible[written++] = (uint32_t) i;
+    }
+
+    visible.resize(written);
+    return written;
+}
+
+size_t cullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, std::vector<uint32_t> &visible) {
+    size_t count = boxes.size();
+    visible.resize(count);
+    size_t written = 0;
+    size_t i = 0;
+
+#if defined(KIRA_CULLING_AVX) || defined(KIRA_CULLING_SSE)
+    for (; i + CULL_LANES <= count; i += CULL_LANES) {
+        written += appendVisible(boxesVisibleMask(frustum, boxes, i), i, &visible[written]);
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (boxVisible(frustum, boxes, i)) visible[written++] = (uint32_t) i;
+    }
+
+    visible.resize(written);
+    return written;
+}
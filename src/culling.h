@@ -0,0 +1,62 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_CULLING_H
+#define KIRA_SOURCE_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// six planes facing into the frustum, xyz is the unit normal and w the distance so dot(n, p) + w >= 0 is inside.
+// order: left, right, bottom, top, near, far
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// Gribb / Hartmann plane extraction from a view-projection matrix, planes come out in the space the matrix maps from
+Frustum extractFrustum(const glm::mat4 &viewProjection);
+
+// bounding spheres in structure of arrays layout so they can be tested several at a time
+struct BoundingSpheres {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    size_t add(const glm::vec3 &center, float sphereRadius);
+    void set(size_t index, const glm::vec3 &center, float sphereRadius);
+    void clear();
+
+    size_t size() const {
+        return radius.size();
+    }
+};
+
+// axis aligned boxes in structure of arrays layout
+struct BoundingBoxes {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    size_t add(const glm::vec3 &minimum, const glm::vec3 &maximum);
+    void set(size_t index, const glm::vec3 &minimum, const glm::vec3 &maximum);
+    void clear();
+
+    size_t size() const {
+        return minX.size();
+    }
+};
+
+// writes the indices of the spheres / boxes that touch the frustum into visible, in ascending order, and returns how
+// many there are. visible is resized to hold every object. uses AVX or SSE when the build targets it
+size_t cullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, std::vector<uint32_t> &visible);
+size_t cullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, std::vector<uint32_t> &visible);
+
+#endif //KIRA_SOURCE_CULLING_H
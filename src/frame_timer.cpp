@@ -0,0 +1,74 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "frame_timer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+
+FrameTimeSummary summarizeFrameTimes(std::vector<double> times) {
+    FrameTimeSummary summary;
+    if (times.empty()) return summary;
+
+    std::sort(times.begin(), times.end());
+    summary.frames = times.size();
+
+    double total = 0.0;
+    for (double time: times) total += time;
+    summary.mean = total / (double) times.size();
+
+    auto percentile = [&times](double p) {
+        auto rank = (size_t) std::ceil(p / 100.0 * (double) times.size());
+        return times[std::min(std::max<size_t>(rank, 1), times.size()) - 1];
+    };
+    summary.p50 = percentile(50.0);
+    summary.p95 = percentile(95.0);
+    summary.p99 = percentile(99.0);
+    summary.max = times.back();
+    return summary;
+}
+
+GpuFrameTimer::GpuFrameTimer(unsigned int latency) : queries(std::max(latency, 1u)) {
+    glGenQueries((GLsizei) queries.size(), queries.data());
+}
+
+GpuFrameTimer::~GpuFrameTimer() {
+    glDeleteQueries((GLsizei) queries.size(), queries.data());
+}
+
+void GpuFrameTimer::begin() {
+    // every query is still in flight, the oldest one has to come back before it can be reused
+    if (waiting == queries.size()) readOldest(finished);
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[(first + waiting) % queries.size()]);
+}
+
+void GpuFrameTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    waiting++;
+}
+
+void GpuFrameTimer::collect(std::vector<double> &times, bool wait) {
+    times.insert(times.end(), finished.begin(), finished.end());
+    finished.clear();
+
+    while (waiting > 0) {
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries[first], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) return;
+        }
+        readOldest(times);
+    }
+}
+
+void GpuFrameTimer::readOldest(std::vector<double> &times) {
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries[first], GL_QUERY_RESULT, &nanoseconds);
+    times.push_back((double) nanoseconds / 1.0e6);
+    first = (first + 1) % queries.size();
+    waiting--;
+}
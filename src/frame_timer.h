@@ -0,0 +1,52 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_FRAME_TIMER_H
+#define KIRA_SOURCE_FRAME_TIMER_H
+
+#include <cstddef>
+#include <vector>
+
+// statistics of a run of frame times, all in milliseconds
+struct FrameTimeSummary {
+    size_t frames = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// nearest rank percentiles, so every reported value is a frame that actually happened
+FrameTimeSummary summarizeFrameTimes(std::vector<double> times);
+
+// times the gpu work of each frame with GL_TIME_ELAPSED queries. a result is only read once the gpu has made it
+// available, a few frames later, so timing never stalls the cpu waiting on the gpu
+class GpuFrameTimer {
+public:
+    // latency is how many frames can be waiting for their result at once
+    explicit GpuFrameTimer(unsigned int latency = 4);
+
+    GpuFrameTimer(const GpuFrameTimer &) = delete;
+    GpuFrameTimer &operator=(const GpuFrameTimer &) = delete;
+
+    ~GpuFrameTimer();
+
+    // around all of the frame's GL commands, time elapsed queries can't nest
+    void begin();
+    void end();
+
+    // appends the results that came back since the last call in frame order, wait blocks until every frame has one
+    void collect(std::vector<double> &times, bool wait = false);
+
+private:
+    std::vector<unsigned int> queries;
+    size_t first = 0;  // oldest frame still waiting for its result
+    size_t waiting = 0;
+    std::vector<double> finished; // results read early because their query was needed again
+
+    void readOldest(std::vector<double> &times);
+};
+
+#endif //KIRA_SOURCE_FRAME_TIMER_H
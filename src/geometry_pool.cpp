@@ -0,0 +1,170 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "geometry_pool.h"
+#include "includes/GL_STATE_CACHE.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+// RANGE ALLOCATOR
+// ---------------
+GeometryPool::RangeAllocator::RangeAllocator(unsigned int capacity) : capacity(capacity) {
+    if (capacity > 0) freeRanges[0] = capacity;
+}
+
+bool GeometryPool::RangeAllocator::allocate(unsigned int count, unsigned int &offset) {
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second < count) continue;
+
+        offset = it->first;
+        unsigned int remaining = it->second - count;
+        freeRanges.erase(it);
+        if (remaining > 0) freeRanges[offset + count] = remaining;
+        return true;
+    }
+    return false;
+}
+
+void GeometryPool::RangeAllocator::release(unsigned int offset, unsigned int count) {
+    if (count == 0) return;
+
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            count += previous->second;
+            freeRanges.erase(previous);
+        }
+    }
+    if (next != freeRanges.end() && offset + count == next->first) {
+        count += next->second;
+        freeRanges.erase(next);
+    }
+    freeRanges[offset] = count;
+}
+
+void GeometryPool::RangeAllocator::grow(unsigned int newCapacity) {
+    if (newCapacity <= capacity) return;
+    unsigned int added = newCapacity - capacity;
+    unsigned int offset = capacity;
+    capacity = newCapacity;
+    release(offset, added);
+}
+
+// POOL
+// ----
+GeometryPool::GeometryPool(const VertexFormat &format, const VertexDecode &decode, unsigned int vertexCapacity, unsigned int indexCapacity)
+        : format(format), decode(decode), stride(vertexStride(format)), vertexRanges(vertexCapacity), indexRanges(indexCapacity) {
+    glGenBuffers(1, &vertexBuffer);
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) vertexCapacity * stride, nullptr, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &indexBuffer);
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) indexCapacity * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+
+    glGenVertexArrays(1, &vertexArray);
+    setupVertexArray();
+    instances.attach(vertexArray);
+}
+
+GeometryPool::~GeometryPool() {
+    glState().deleteVertexArrays(1, &vertexArray);
+    glState().deleteBuffers(1, &vertexBuffer);
+    glState().deleteBuffers(1, &indexBuffer);
+}
+
+int32_t GeometryPool::add(const MeshData &data, const InstanceData &instance) {
+    GeometryRange range;
+    range.vertexCount = (unsigned int) data.vertices.size();
+    range.indexCount = (unsigned int) data.indices.size();
+    range.baseVertex = (int) allocateRange(vertexRanges, vertexBuffer, stride, range.vertexCount);
+    range.firstIndex = allocateRange(indexRanges, indexBuffer, sizeof(unsigned int), range.indexCount);
+
+    std::vector<unsigned char> packed = packVerticesWithDecode(data.vertices, format, decode);
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) range.baseVertex * stride, (GLsizeiptr) packed.size(), packed.data());
+
+    // indices stay relative to the mesh, the draws add the base vertex
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) range.firstIndex * sizeof(unsigned int), (GLsizeiptr) (data.indices.size() * sizeof(unsigned int)), data.indices.data());
+
+    // the handle doubles as the instance slot
+    int32_t handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = (int32_t) meshes.size();
+        meshes.emplace_back();
+    }
+    range.baseInstance = (unsigned int) handle;
+    meshes[handle] = range;
+
+    if ((size_t) handle < instanceData.size()) {
+        instanceData[handle] = instance;
+        glState().bindBuffer(GL_ARRAY_BUFFER, instances.ID);
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) handle * sizeof(InstanceData), sizeof(InstanceData), &instance);
+    } else {
+        instanceData.resize(std::max<size_t>(instanceData.size() * 2, 64));
+        instanceData[handle] = instance;
+        instances.update(instanceData);
+    }
+
+    return handle;
+}
+
+void GeometryPool::remove(int32_t handle) {
+    GeometryRange &range = meshes[handle];
+    vertexRanges.release((unsigned int) range.baseVertex, range.vertexCount);
+    indexRanges.release(range.firstIndex, range.indexCount);
+    range = GeometryRange();
+    freeHandles.push_back(handle);
+}
+
+size_t GeometryPool::getByteSize(int32_t handle) const {
+    const GeometryRange &range = meshes[handle];
+    return (size_t) range.vertexCount * stride + (size_t) range.indexCount * sizeof(unsigned int) + sizeof(InstanceData);
+}
+
+size_t GeometryPool::getCapacityBytes() const {
+    return (size_t) vertexRanges.getCapacity() * stride + (size_t) indexRanges.getCapacity() * sizeof(unsigned int) +
+           instanceData.size() * sizeof(InstanceData);
+}
+
+// takes count elements from the allocator, moving the buffer's contents to one at least twice the size when it is full
+unsigned int GeometryPool::allocateRange(RangeAllocator &ranges, unsigned int &buffer, size_t elementSize, unsigned int count) {
+    unsigned int offset = 0;
+    if (count == 0 || ranges.allocate(count, offset)) return offset;
+
+    unsigned int oldCapacity = ranges.getCapacity();
+    unsigned int newCapacity = std::max(oldCapacity * 2, oldCapacity + count);
+
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) (newCapacity * elementSize), nullptr, GL_STATIC_DRAW);
+    glState().bindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr) (oldCapacity * elementSize));
+    glState().deleteBuffers(1, &buffer);
+    buffer = grown;
+
+    // the vertex array still points at the old buffer
+    setupVertexArray();
+
+    ranges.grow(newCapacity);
+    ranges.allocate(count, offset);
+    return offset;
+}
+
+void GeometryPool::setupVertexArray() const {
+    glState().bindVertexArray(vertexArray);
+    glState().bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    setVertexAttributes(format);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glState().bindVertexArray(0);
+}
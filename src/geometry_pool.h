@@ -0,0 +1,103 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_GEOMETRY_POOL_H
+#define KIRA_SOURCE_GEOMETRY_POOL_H
+
+#include "mesh.h"
+#include "includes/INSTANCE_BUFFER.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// where a mesh lives in a pool, in the units the draw calls take
+struct GeometryRange {
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    int baseVertex = 0;
+    unsigned int vertexCount = 0;
+    unsigned int baseInstance = 0; // the mesh's instance slot
+};
+
+// one vertex, index and instance buffer shared by many meshes packed with the same format and decode, so they are
+// all drawn from one vertex array and their draws can be merged into one multi draw. each mesh gets an instance slot
+// holding its transform, which its draw reads through the base instance. the buffers grow as needed
+class GeometryPool {
+public:
+    GeometryPool(const VertexFormat &format, const VertexDecode &decode, unsigned int vertexCapacity = 1u << 18, unsigned int indexCapacity = 1u << 20);
+
+    GeometryPool(const GeometryPool &) = delete;
+    GeometryPool &operator=(const GeometryPool &) = delete;
+
+    ~GeometryPool();
+
+    // packs the mesh into the pool and returns its handle
+    int32_t add(const MeshData &data, const InstanceData &instance);
+
+    void remove(int32_t handle);
+
+    const GeometryRange &getRange(int32_t handle) const {
+        return meshes[handle];
+    }
+
+    // gpu bytes of one mesh, its instance slot included
+    size_t getByteSize(int32_t handle) const;
+
+    unsigned int getVertexArray() const {
+        return vertexArray;
+    }
+
+    const VertexFormat &getFormat() const {
+        return format;
+    }
+
+    const VertexDecode &getDecode() const {
+        return decode;
+    }
+
+    // gpu bytes allocated for all three buffers
+    size_t getCapacityBytes() const;
+
+private:
+    // first fit allocator over a range of elements, neighbouring free ranges are merged
+    class RangeAllocator {
+    public:
+        explicit RangeAllocator(unsigned int capacity);
+
+        bool allocate(unsigned int count, unsigned int &offset);
+        void release(unsigned int offset, unsigned int count);
+        void grow(unsigned int newCapacity);
+
+        unsigned int getCapacity() const {
+            return capacity;
+        }
+
+    private:
+        std::map<unsigned int, unsigned int> freeRanges; // offset to count
+        unsigned int capacity;
+    };
+
+    VertexFormat format;
+    VertexDecode decode;
+    unsigned int stride;
+
+    unsigned int vertexBuffer = 0;
+    unsigned int indexBuffer = 0;
+    unsigned int vertexArray = 0;
+    RangeAllocator vertexRanges;
+    RangeAllocator indexRanges;
+
+    InstanceBuffer instances;
+    std::vector<InstanceData> instanceData; // mirror of the instance buffer, it is reuploaded whole when it grows
+
+    std::vector<GeometryRange> meshes;
+    std::vector<int32_t> freeHandles;
+
+    unsigned int allocateRange(RangeAllocator &ranges, unsigned int &buffer, size_t elementSize, unsigned int count);
+    void setupVertexArray() const;
+};
+
+#endif //KIRA_SOURCE_GEOMETRY_POOL_H
@@ -0,0 +1,139 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "headless_context.h"
+
+#include <iostream>
+
+#ifdef KIRA_HEADLESS_EGL
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+// extension strings are space separated names
+static bool hasExtension(const char *extensions, const char *name) {
+    if (!extensions) return false;
+    size_t length = std::strlen(name);
+    for (const char *start = extensions; (start = std::strstr(start, name)) != nullptr; start += length) {
+        bool whole = (start == extensions || start[-1] == ' ') && (start[length] == ' ' || start[length] == '\0');
+        if (whole) return true;
+    }
+    return false;
+}
+
+// the surfaceless platform needs neither a display server nor a gpu, the default display is tried when it's missing
+static EGLDisplay openDisplay() {
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless") && hasExtension(clientExtensions, "EGL_EXT_platform_base")) {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+        }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+    return EGL_NO_DISPLAY;
+}
+
+HeadlessContext::~HeadlessContext() {
+    if (!display) return;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) eglDestroySurface(display, surface);
+    if (context) eglDestroyContext(display, context);
+    eglTerminate(display);
+}
+
+bool HeadlessContext::create() {
+    display = openDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        display = nullptr;
+        std::cout << "ERROR::HEADLESS::NO_DISPLAY: eglGetDisplay / eglInitialize failed" << std::endl;
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "ERROR::HEADLESS::NO_OPENGL_API: the EGL implementation only does OpenGL ES" << std::endl;
+        return false;
+    }
+
+    // a pbuffer capable config when there is one, the surfaceless platform may only have configs without surfaces
+    EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        configAttributes[1] = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+            std::cout << "ERROR::HEADLESS::NO_CONFIG: no EGL config renders OpenGL" << std::endl;
+            return false;
+        }
+    }
+
+    // same versions the window asks for, newest first
+    for (int minor = 6; minor >= 2 && !context; minor--) {
+        const EGLint contextAttributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, 4,
+                EGL_CONTEXT_MINOR_VERSION, minor,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    }
+    if (!context) {
+        std::cout << "ERROR::HEADLESS::CONTEXT_CREATION_FAILED: no 4.2 core context, EGL error 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+
+    // without surfaceless contexts a tiny pbuffer stands in for the surface, nothing is drawn into it
+    if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint surfaceAttributes[] = {EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if (surface == EGL_NO_SURFACE) {
+            surface = nullptr;
+            std::cout << "ERROR::HEADLESS::PBUFFER_CREATION_FAILED: EGL error 0x" << std::hex << eglGetError() << std::dec << std::endl;
+            return false;
+        }
+    }
+
+    if (!eglMakeCurrent(display, surface ? surface : EGL_NO_SURFACE, surface ? surface : EGL_NO_SURFACE, context)) {
+        std::cout << "ERROR::HEADLESS::MAKE_CURRENT_FAILED: EGL error 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+
+    std::cout << "Headless context: " << eglQueryString(display, EGL_VENDOR) << ", EGL " << eglQueryString(display, EGL_VERSION) << std::endl;
+    return true;
+}
+
+void *HeadlessContext::getProcAddress(const char *name) {
+    return (void *) eglGetProcAddress(name);
+}
+
+#else
+
+HeadlessContext::~HeadlessContext() = default;
+
+bool HeadlessContext::create() {
+    std::cout << "ERROR::HEADLESS::UNAVAILABLE: built without EGL, reconfigure with EGL installed" << std::endl;
+    return false;
+}
+
+void *HeadlessContext::getProcAddress(const char *) {
+    return nullptr;
+}
+
+#endif
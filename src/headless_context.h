@@ -0,0 +1,34 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_HEADLESS_CONTEXT_H
+#define KIRA_SOURCE_HEADLESS_CONTEXT_H
+
+// an OpenGL core context without a window or a display, made through EGL. it has no default framebuffer worth
+// drawing into, everything is rendered to framebuffer objects. works on a gpu driver as well as Mesa's llvmpipe.
+// only available when the engine is built against EGL (KIRA_HEADLESS_EGL), otherwise create() fails
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+    // releases the context, every GL object has to be deleted before this runs
+    ~HeadlessContext();
+
+    // makes a 4.x core context current on this thread, the newest one the driver offers down to 4.2
+    bool create();
+
+    // for gladLoadGLLoader and GLExtensions::load
+    static void *getProcAddress(const char *name);
+
+private:
+    // EGLDisplay, EGLContext and EGLSurface, kept opaque so the header doesn't pull in EGL
+    void *display = nullptr;
+    void *context = nullptr;
+    void *surface = nullptr;
+};
+
+#endif //KIRA_SOURCE_HEADLESS_CONTEXT_H
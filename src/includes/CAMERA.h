@@ -1,166 +1,166 @@
-﻿#ifndef CAMERA_H
-#define CAMERA_H
-
-#include <glad/glad.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-
-#include <vector>
-
-// Defines several possible options for camera movement. Used as abstraction to stay away from window-system specific input methods
-enum Camera_Movement {
-    FORWARD,
-    BACKWARD,
-    LEFT,
-    RIGHT,
-    UP,
-    DOWN
-};
-
-// Scrollwheel mode
-enum SCROLL_MODE {
-    SCROLL_ZOOM,
-    SCROLL_SPEED
-};
-
-
-// Default camera values
-const float YAW = -90.0f;
-const float PITCH = 0.0f;
-const float SPEED = 2.5f;
-const float MOUSE_SENSITIVITY = 0.1f;
-const float SCROLL_SENSTIVITY = 0.25f;
-const float ZOOM = 45.0f;
-
-const float MIN_SPEED = 1.0f;
-const float MAX_SPEED = 10.0f;
-
-// An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
-class Camera {
-public:
-    // camera Attributes
-    glm::vec3 Position;
-    glm::vec3 Front;
-    glm::vec3 Up;
-    glm::vec3 Right;
-    glm::vec3 WorldUp;
-    bool BoostOn = false;
-
-    // euler Angles
-    float Yaw;
-    float Pitch;
-
-    // camera options
-    float MovementSpeed;
-    float BoostMultiplier = 2.5f;
-    float MouseSensitivity;
-    float ScrollSensitvity;
-    float Zoom;
-
-    SCROLL_MODE ScrollMode = SCROLL_MODE::SCROLL_SPEED;
-
-    // constructor with vectors
-    Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH, SCROLL_MODE scrollMode = SCROLL_MODE::SCROLL_SPEED) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(MOUSE_SENSITIVITY), Zoom(ZOOM), ScrollSensitvity(SCROLL_SENSTIVITY) {
-        Position = position;
-        WorldUp = up;
-        Yaw = yaw;
-        Pitch = pitch;
-        ScrollMode = scrollMode;
-        updateCameraVectors();
-    }
-
-    // constructor with scalar values
-    Camera(float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(MOUSE_SENSITIVITY), Zoom(ZOOM) {
-        Position = glm::vec3(posX, posY, posZ);
-        WorldUp = glm::vec3(upX, upY, upZ);
-        Yaw = yaw;
-        Pitch = pitch;
-        updateCameraVectors();
-    }
-
-    // returns the view matrix calculated using Euler Angles and the LookAt Matrix
-    glm::mat4 GetViewMatrix() {
-        return glm::lookAt(Position, Position + Front, Up);
-    }
-
-    // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
-    void Move(Camera_Movement direction, float deltaTime) {
-        float currentSpeed = MovementSpeed;
-        if (BoostOn) currentSpeed *= BoostMultiplier;
-
-        float velocity = currentSpeed * deltaTime;
-
-        if (direction == FORWARD)
-            Position += Front * velocity;
-        if (direction == BACKWARD)
-            Position -= Front * velocity;
-        if (direction == LEFT)
-            Position -= Right * velocity;
-        if (direction == RIGHT)
-            Position += Right * velocity;
-        if (direction == UP)
-            Position += Up * velocity;
-        if (direction == DOWN)
-            Position -= Up * velocity;
-    }
-
-    void Move(glm::vec3 direction, float deltaTime) {
-        float velocity = MovementSpeed * deltaTime;
-        Position += direction * velocity;
-    }
-
-    void SetBoost(int boostOn) {
-        BoostOn = boostOn;
-    }
-
-    // processes input received from a mouse input system. Expects the offset value in both the x and y direction.
-    void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true) {
-        xoffset *= MouseSensitivity;
-        yoffset *= MouseSensitivity;
-
-        Yaw += xoffset;
-        Pitch += yoffset;
-
-        // make sure that when pitch is out of bounds, screen doesn't get flipped
-        if (constrainPitch) {
-            if (Pitch > 89.0f)
-                Pitch = 89.0f;
-            if (Pitch < -89.0f)
-                Pitch = -89.0f;
-        }
-
-        // update Front, Right and Up Vectors using the updated Euler angles
-        updateCameraVectors();
-    }
-
-    // processes input received from a mouse scroll-wheel event. Only requires input on the vertical wheel-axis
-    void ProcessMouseScroll(float yoffset) {
-        if (ScrollMode == SCROLL_MODE::SCROLL_ZOOM) {
-            Zoom -= (float) yoffset;
-            if (Zoom < 1.0f)
-                Zoom = 1.0f;
-            if (Zoom > 45.0f)
-                Zoom = 45.0f;
-        } else if (ScrollMode == SCROLL_MODE::SCROLL_SPEED) {
-            MovementSpeed += yoffset * ScrollSensitvity;
-            if (MovementSpeed < MIN_SPEED) MovementSpeed = MIN_SPEED;
-            else if (MovementSpeed > MAX_SPEED) MovementSpeed = MAX_SPEED;
-        }
-    }
-
-private:
-    // calculates the front vector from the Camera's (updated) Euler Angles
-    void updateCameraVectors() {
-        // calculate the new Front vector
-        glm::vec3 front;
-        front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
-        front.y = sin(glm::radians(Pitch));
-        front.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
-        Front = glm::normalize(front);
-        // also re-calculate the Right and Up vector
-        Right = glm::normalize(glm::cross(Front, WorldUp));  // normalize the vectors, because their length gets closer to 0 the more you look up or down which results in slower movement.
-        Up = glm::normalize(glm::cross(Right, Front));
-    }
-};
-
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+
+// Defines several possible options for camera movement. Used as abstraction to stay away from window-system specific input methods
+enum Camera_Movement {
+    FORWARD,
+    BACKWARD,
+    LEFT,
+    RIGHT,
+    UP,
+    DOWN
+};
+
+// Scrollwheel mode
+enum SCROLL_MODE {
+    SCROLL_ZOOM,
+    SCROLL_SPEED
+};
+
+
+// Default camera values
+const float YAW = -90.0f;
+const float PITCH = 0.0f;
+const float SPEED = 2.5f;
+const float MOUSE_SENSITIVITY = 0.1f;
+const float SCROLL_SENSTIVITY = 0.25f;
+const float ZOOM = 45.0f;
+
+const float MIN_SPEED = 1.0f;
+const float MAX_SPEED = 10.0f;
+
+// An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
+class Camera {
+public:
+    // camera Attributes
+    glm::vec3 Position;
+    glm::vec3 Front;
+    glm::vec3 Up;
+    glm::vec3 Right;
+    glm::vec3 WorldUp;
+    bool BoostOn = false;
+
+    // euler Angles
+    float Yaw;
+    float Pitch;
+
+    // camera options
+    float MovementSpeed;
+    float BoostMultiplier = 2.5f;
+    float MouseSensitivity;
+    float ScrollSensitvity;
+    float Zoom;
+
+    SCROLL_MODE ScrollMode = SCROLL_MODE::SCROLL_SPEED;
+
+    // constructor with vectors
+    Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH, SCROLL_MODE scrollMode = SCROLL_MODE::SCROLL_SPEED) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(MOUSE_SENSITIVITY), Zoom(ZOOM), ScrollSensitvity(SCROLL_SENSTIVITY) {
+        Position = position;
+        WorldUp = up;
+        Yaw = yaw;
+        Pitch = pitch;
+        ScrollMode = scrollMode;
+        updateCameraVectors();
+    }
+
+    // constructor with scalar values
+    Camera(float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(MOUSE_SENSITIVITY), Zoom(ZOOM) {
+        Position = glm::vec3(posX, posY, posZ);
+        WorldUp = glm::vec3(upX, upY, upZ);
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
+    // returns the view matrix calculated using Euler Angles and the LookAt Matrix
+    glm::mat4 GetViewMatrix() {
+        return glm::lookAt(Position, Position + Front, Up);
+    }
+
+    // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
+    void Move(Camera_Movement direction, float deltaTime) {
+        float currentSpeed = MovementSpeed;
+        if (BoostOn) currentSpeed *= BoostMultiplier;
+
+        float velocity = currentSpeed * deltaTime;
+
+        if (direction == FORWARD)
+            Position += Front * velocity;
+        if (direction == BACKWARD)
+            Position -= Front * velocity;
+        if (direction == LEFT)
+            Position -= Right * velocity;
+        if (direction == RIGHT)
+            Position += Right * velocity;
+        if (direction == UP)
+            Position += Up * velocity;
+        if (direction == DOWN)
+            Position -= Up * velocity;
+    }
+
+    void Move(glm::vec3 direction, float deltaTime) {
+        float velocity = MovementSpeed * deltaTime;
+        Position += direction * velocity;
+    }
+
+    void SetBoost(int boostOn) {
+        BoostOn = boostOn;
+    }
+
+    // processes input received from a mouse input system. Expects the offset value in both the x and y direction.
+    void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true) {
+        xoffset *= MouseSensitivity;
+        yoffset *= MouseSensitivity;
+
+        Yaw += xoffset;
+        Pitch += yoffset;
+
+        // make sure that when pitch is out of bounds, screen doesn't get flipped
+        if (constrainPitch) {
+            if (Pitch > 89.0f)
+                Pitch = 89.0f;
+            if (Pitch < -89.0f)
+                Pitch = -89.0f;
+        }
+
+        // update Front, Right and Up Vectors using the updated Euler angles
+        updateCameraVectors();
+    }
+
+    // processes input received from a mouse scroll-wheel event. Only requires input on the vertical wheel-axis
+    void ProcessMouseScroll(float yoffset) {
+        if (ScrollMode == SCROLL_MODE::SCROLL_ZOOM) {
+            Zoom -= (float) yoffset;
+            if (Zoom < 1.0f)
+                Zoom = 1.0f;
+            if (Zoom > 45.0f)
+                Zoom = 45.0f;
+        } else if (ScrollMode == SCROLL_MODE::SCROLL_SPEED) {
+            MovementSpeed += yoffset * ScrollSensitvity;
+            if (MovementSpeed < MIN_SPEED) MovementSpeed = MIN_SPEED;
+            else if (MovementSpeed > MAX_SPEED) MovementSpeed = MAX_SPEED;
+        }
+    }
+
+private:
+    // calculates the front vector from the Camera's (updated) Euler Angles
+    void updateCameraVectors() {
+        // calculate the new Front vector
+        glm::vec3 front;
+        front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
+        front.y = sin(glm::radians(Pitch));
+        front.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
+        Front = glm::normalize(front);
+        // also re-calculate the Right and Up vector
+        Right = glm::normalize(glm::cross(Front, WorldUp));  // normalize the vectors, because their length gets closer to 0 the more you look up or down which results in slower movement.
+        Up = glm::normalize(glm::cross(Right, Front));
+    }
+};
+
 #endif
\ No newline at end of file
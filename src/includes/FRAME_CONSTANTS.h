@@ -0,0 +1,61 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_FRAME_CONSTANTS_H
+#define GRAPHICS_ENGINE_GLFW_FRAME_CONSTANTS_H
+
+#include <glm/glm.hpp>
+
+#include "UNIFORM_BUFFER.h"
+#include "RING_BUFFER.h"
+#include "CAMERA.h"
+
+// std140 mirror of the FrameConstants block in shaders/common/frame_constants.glsl
+struct FrameConstantsData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::mat4 inverseViewProjection;
+    glm::vec3 cameraPosition;
+    float time;
+};
+
+static_assert(sizeof(FrameConstantsData) == 272, "FrameConstants does not match the std140 layout");
+
+// camera data every shader needs, written once per frame instead of once per program. each frame's copy goes to the
+// ring buffer and is bound with glBindBufferRange, so the gpu can still read last frame's while this one is written
+class FrameConstants {
+public:
+    explicit FrameConstants(RingBuffer &ring) : ring(ring) {
+        GLint offsetAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+        alignment = offsetAlignment > 0 ? (size_t) offsetAlignment : 256;
+    }
+
+    void update(Camera &camera, const glm::mat4 &projection, float time) {
+        data.view = camera.GetViewMatrix();
+        data.projection = projection;
+        data.viewProjection = projection * data.view;
+        // lets the deferred lighting pass rebuild world positions from depth
+        data.inverseViewProjection = glm::inverse(data.viewProjection);
+        data.cameraPosition = camera.Position;
+        data.time = time;
+
+        RingAllocation allocation = ring.write(&data, sizeof(data), alignment);
+        if (allocation.data) {
+            glState().bindBufferRange(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, ring.ID, (GLintptr) allocation.offset, sizeof(data));
+        }
+    }
+
+    const FrameConstantsData &get() const {
+        return data;
+    }
+
+private:
+    RingBuffer &ring;
+    size_t alignment;
+    FrameConstantsData data{};
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_FRAME_CONSTANTS_H
@@ -0,0 +1,107 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_GBUFFER_H
+#define GRAPHICS_ENGINE_GLFW_GBUFFER_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+
+#include <iostream>
+
+// texture units the lighting pass reads the g-buffer from, these must match shaders/deferred/deferred_lighting_fragment.glsl
+enum GBufferTextureUnit {
+    GBUFFER_ALBEDO_SPEC_UNIT = 0,
+    GBUFFER_NORMAL_UNIT = 1,
+    GBUFFER_DEPTH_UNIT = 2
+};
+
+// render targets of the deferred path, the geometry pass writes material data here and the lighting pass shades
+// every covered pixel exactly once
+class GBuffer {
+public:
+    // framebuffer id
+    unsigned int ID = 0;
+    unsigned int AlbedoSpec = 0;      // RGBA8, rgb albedo, a specular intensity
+    unsigned int NormalShininess = 0; // RGBA16F, xyz world space normal, w shininess
+    unsigned int Depth = 0;           // DEPTH24_STENCIL8 so it can be blitted into the default framebuffer
+    int Width = 0;
+    int Height = 0;
+
+    GBuffer(int width, int height) {
+        glGenFramebuffers(1, &ID);
+        glGenTextures(1, &AlbedoSpec);
+        glGenTextures(1, &NormalShininess);
+        glGenTextures(1, &Depth);
+        resize(width, height);
+    }
+
+    GBuffer(const GBuffer &) = delete;
+    GBuffer &operator=(const GBuffer &) = delete;
+
+    ~GBuffer() {
+        glState().deleteTextures(1, &AlbedoSpec);
+        glState().deleteTextures(1, &NormalShininess);
+        glState().deleteTextures(1, &Depth);
+        glState().deleteFramebuffers(1, &ID);
+    }
+
+    // reallocates the attachments, only does work when the size actually changed
+    void resize(int width, int height) {
+        if (width == Width && height == Height) return;
+        Width = width;
+        Height = height;
+
+        allocate(AlbedoSpec, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+        allocate(NormalShininess, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        allocate(Depth, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8);
+
+        glState().bindFramebuffer(GL_FRAMEBUFFER, ID);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, AlbedoSpec, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, NormalShininess, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, Depth, 0);
+
+        const GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, attachments);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::GBUFFER::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        }
+
+        glState().bindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    // geometry pass target
+    void bindForWriting() const {
+        glState().bindFramebuffer(GL_FRAMEBUFFER, ID);
+    }
+
+    // lighting pass inputs
+    void bindTextures() const {
+        glState().bindTexture(GBUFFER_ALBEDO_SPEC_UNIT, GL_TEXTURE_2D, AlbedoSpec);
+        glState().bindTexture(GBUFFER_NORMAL_UNIT, GL_TEXTURE_2D, NormalShininess);
+        glState().bindTexture(GBUFFER_DEPTH_UNIT, GL_TEXTURE_2D, Depth);
+    }
+
+    // copies the scene depth into the target framebuffer (the default one unless rendering offscreen) so forward
+    // drawn objects are still depth tested against it, the target is left bound
+    void blitDepth(unsigned int target = 0) const {
+        glState().bindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+        glState().bindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        glBlitFramebuffer(0, 0, Width, Height, 0, 0, Width, Height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glState().bindFramebuffer(GL_FRAMEBUFFER, target);
+    }
+
+private:
+    void allocate(unsigned int texture, GLint internalFormat, GLenum format, GLenum type) const {
+        glState().bindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Width, Height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_GBUFFER_H
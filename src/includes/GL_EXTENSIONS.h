@@ -0,0 +1,90 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_GL_EXTENSIONS_H
+#define GRAPHICS_ENGINE_GLFW_GL_EXTENSIONS_H
+
+#include "glad/glad.h"
+
+#include <cstring>
+#include <iostream>
+
+// the generated loader stops at 4.2 core, these are the newer entry points the engine uses when the driver has them.
+// every one of them is optional, callers check the flag and keep a 4.2 path
+
+// ARB_buffer_storage / 4.4
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP PFNKIRABUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+// ARB_multi_draw_indirect / 4.3, the commands are read from the buffer bound to GL_DRAW_INDIRECT_BUFFER
+typedef void (APIENTRYP PFNKIRAMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawCount, GLsizei stride);
+
+// layout fixed by the spec, one per draw of a multi draw
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+class GLExtensions {
+public:
+    bool bufferStorage = false;
+    PFNKIRABUFFERSTORAGEPROC BufferStorage = nullptr;
+    bool multiDrawIndirect = false;
+    PFNKIRAMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect = nullptr;
+    // BC1 formats, never core. sRGB BC1 needs the sRGB extension as well
+    bool textureCompressionS3tc = false;
+    bool textureCompressionS3tcSrgb = false;
+
+    static GLExtensions &global() {
+        static GLExtensions extensions;
+        return extensions;
+    }
+
+    // call once after gladLoadGLLoader with the same loader
+    void load(GLADloadproc loader) {
+        if (supports(4, 4, "GL_ARB_buffer_storage")) {
+            BufferStorage = (PFNKIRABUFFERSTORAGEPROC) loader("glBufferStorage");
+            bufferStorage = BufferStorage != nullptr;
+        }
+
+        if (supports(4, 3, "GL_ARB_multi_draw_indirect")) {
+            MultiDrawElementsIndirect = (PFNKIRAMULTIDRAWELEMENTSINDIRECTPROC) loader("glMultiDrawElementsIndirect");
+            multiDrawIndirect = MultiDrawElementsIndirect != nullptr;
+        }
+
+        textureCompressionS3tc = hasExtension("GL_EXT_texture_compression_s3tc");
+        textureCompressionS3tcSrgb = textureCompressionS3tc && (hasExtension("GL_EXT_texture_sRGB") || hasExtension("GL_EXT_texture_compression_s3tc_srgb"));
+
+        std::cout << "GL " << GLVersion.major << "." << GLVersion.minor << ", buffer storage " << (bufferStorage ? "yes" : "no")
+                  << ", multi draw indirect " << (multiDrawIndirect ? "yes" : "no") << ", s3tc " << (textureCompressionS3tc ? "yes" : "no") << std::endl;
+    }
+
+private:
+    // core since the given version, or advertised as an extension
+    static bool supports(int major, int minor, const char *extension) {
+        if (GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor)) return true;
+        return hasExtension(extension);
+    }
+
+    static bool hasExtension(const char *extension) {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char *name = (const char *) glGetStringi(GL_EXTENSIONS, (GLuint) i);
+            if (name && std::strcmp(name, extension) == 0) return true;
+        }
+        return false;
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_GL_EXTENSIONS_H
@@ -0,0 +1,326 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_GL_STATE_CACHE_H
+#define GRAPHICS_ENGINE_GLFW_GL_STATE_CACHE_H
+
+#include "glad/glad.h"
+
+#include <cstddef>
+
+// texture units and buffer targets past these are passed straight to the driver
+const unsigned int GL_STATE_TEXTURE_UNITS = 32;
+
+struct GLStateStats {
+    size_t issued = 0; // calls that reached the driver
+    size_t elided = 0; // calls dropped because the state was already set
+};
+
+// shadows the bound objects and fixed function state of the context, so setting what is already set never reaches
+// the driver. every bind in the engine has to go through it or the shadow goes stale, objects are deleted through it
+// too because deleting a bound object unbinds it and its name can be handed out again.
+// nothing is assumed about the context at the start, the first call for every piece of state is always issued
+class GLStateCache {
+public:
+    GLStateCache() {
+        invalidate();
+    }
+
+    GLStateCache(const GLStateCache &) = delete;
+    GLStateCache &operator=(const GLStateCache &) = delete;
+
+    // forgets everything, for code that touched the context behind the cache's back
+    void invalidate() {
+        program = UNKNOWN;
+        vertexArray = UNKNOWN;
+        drawFramebuffer = UNKNOWN;
+        readFramebuffer = UNKNOWN;
+        activeUnit = UNKNOWN;
+        for (unsigned int &buffer: buffers) buffer = UNKNOWN;
+        for (unsigned int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++) {
+            for (unsigned int &texture: textures[unit]) texture = UNKNOWN;
+            samplers[unit] = UNKNOWN;
+        }
+        for (int &capability: capabilities) capability = -1;
+        depthFunc = UNKNOWN;
+        depthMask = -1;
+        blendSource = UNKNOWN;
+        blendDestination = UNKNOWN;
+        polygonMode = UNKNOWN;
+    }
+
+    void useProgram(unsigned int id) {
+        if (!changed(program, id)) return;
+        glUseProgram(id);
+    }
+
+    void bindVertexArray(unsigned int id) {
+        if (!changed(vertexArray, id)) return;
+        glBindVertexArray(id);
+    }
+
+    // the element array binding belongs to the bound vertex array, so it is not shadowed
+    void bindBuffer(GLenum target, unsigned int id) {
+        int slot = bufferSlot(target);
+        if (slot < 0) {
+            stats.issued++;
+        } else if (!changed(buffers[slot], id)) {
+            return;
+        }
+        glBindBuffer(target, id);
+    }
+
+    // binding to an indexed binding point also binds the buffer to the target itself
+    void bindBufferBase(GLenum target, unsigned int index, unsigned int id) {
+        int slot = bufferSlot(target);
+        if (slot >= 0) buffers[slot] = id;
+        stats.issued++;
+        glBindBufferBase(target, index, id);
+    }
+
+    void bindBufferRange(GLenum target, unsigned int index, unsigned int id, GLintptr offset, GLsizeiptr size) {
+        int slot = bufferSlot(target);
+        if (slot >= 0) buffers[slot] = id;
+        stats.issued++;
+        glBindBufferRange(target, index, id, offset, size);
+    }
+
+    // GL_FRAMEBUFFER binds both the draw and the read framebuffer
+    void bindFramebuffer(GLenum target, unsigned int id) {
+        bool draw = target != GL_READ_FRAMEBUFFER && drawFramebuffer != id;
+        bool read = target != GL_DRAW_FRAMEBUFFER && readFramebuffer != id;
+        if (!draw && !read) {
+            stats.elided++;
+            return;
+        }
+
+        // binding only the side that differs keeps the call count honest
+        if (target == GL_FRAMEBUFFER && !(draw && read)) target = draw ? GL_DRAW_FRAMEBUFFER : GL_READ_FRAMEBUFFER;
+        if (draw) drawFramebuffer = id;
+        if (read) readFramebuffer = id;
+        stats.issued++;
+        glBindFramebuffer(target, id);
+    }
+
+    void activeTexture(unsigned int unit) {
+        if (!changed(activeUnit, unit)) return;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    // binds to a unit, only switching the active unit when the binding actually has to change
+    void bindTexture(unsigned int unit, GLenum target, unsigned int id) {
+        int slot = textureSlot(target);
+        if (unit >= GL_STATE_TEXTURE_UNITS || slot < 0) {
+            activeTexture(unit);
+            stats.issued++;
+            glBindTexture(target, id);
+            return;
+        }
+
+        if (textures[unit][slot] == id) {
+            stats.elided++;
+            return;
+        }
+        activeTexture(unit);
+        textures[unit][slot] = id;
+        stats.issued++;
+        glBindTexture(target, id);
+    }
+
+    // binds to whichever unit is active, for uploads that don't care which unit they use
+    void bindTexture(GLenum target, unsigned int id) {
+        if (activeUnit == UNKNOWN) activeTexture(0);
+        bindTexture(activeUnit, target, id);
+    }
+
+    void bindSampler(unsigned int unit, unsigned int id) {
+        if (unit < GL_STATE_TEXTURE_UNITS && !changed(samplers[unit], id)) return;
+        if (unit >= GL_STATE_TEXTURE_UNITS) stats.issued++;
+        glBindSampler(unit, id);
+    }
+
+    void enable(GLenum capability) {
+        setCapability(capability, true);
+    }
+
+    void disable(GLenum capability) {
+        setCapability(capability, false);
+    }
+
+    void setDepthFunc(GLenum func) {
+        if (!changed(depthFunc, func)) return;
+        glDepthFunc(func);
+    }
+
+    void setDepthMask(bool write) {
+        if (depthMask == (int) write) {
+            stats.elided++;
+            return;
+        }
+        depthMask = (int) write;
+        stats.issued++;
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+
+    void setBlendFunc(GLenum source, GLenum destination) {
+        if (blendSource == source && blendDestination == destination) {
+            stats.elided++;
+            return;
+        }
+        blendSource = source;
+        blendDestination = destination;
+        stats.issued++;
+        glBlendFunc(source, destination);
+    }
+
+    // core profile only has GL_FRONT_AND_BACK
+    void setPolygonMode(GLenum mode) {
+        if (!changed(polygonMode, mode)) return;
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+
+    // delete through these so a reused name isn't mistaken for the object that was bound
+    void deleteProgram(unsigned int id) {
+        if (program == id) program = 0;
+        glDeleteProgram(id);
+    }
+
+    void deleteVertexArrays(int count, const unsigned int *ids) {
+        for (int i = 0; i < count; i++) {
+            if (ids[i] != 0 && vertexArray == ids[i]) vertexArray = 0;
+        }
+        glDeleteVertexArrays(count, ids);
+    }
+
+    void deleteBuffers(int count, const unsigned int *ids) {
+        for (int i = 0; i < count; i++) {
+            for (unsigned int &buffer: buffers) {
+                if (ids[i] != 0 && buffer == ids[i]) buffer = 0;
+            }
+        }
+        glDeleteBuffers(count, ids);
+    }
+
+    void deleteTextures(int count, const unsigned int *ids) {
+        for (int i = 0; i < count; i++) {
+            for (unsigned int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++) {
+                for (unsigned int &texture: textures[unit]) {
+                    if (ids[i] != 0 && texture == ids[i]) texture = 0;
+                }
+            }
+        }
+        glDeleteTextures(count, ids);
+    }
+
+    void deleteFramebuffers(int count, const unsigned int *ids) {
+        for (int i = 0; i < count; i++) {
+            if (ids[i] == 0) continue;
+            if (drawFramebuffer == ids[i]) drawFramebuffer = 0;
+            if (readFramebuffer == ids[i]) readFramebuffer = 0;
+        }
+        glDeleteFramebuffers(count, ids);
+    }
+
+    unsigned int getProgram() const {
+        return program;
+    }
+
+    unsigned int getVertexArray() const {
+        return vertexArray;
+    }
+
+    const GLStateStats &getStats() const {
+        return stats;
+    }
+
+    void resetStats() {
+        stats = GLStateStats();
+    }
+
+private:
+    static const unsigned int UNKNOWN = 0xFFFFFFFFu;
+
+    // buffer targets that are shadowed, in slot order
+    static int bufferSlot(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER: return 0;
+            case GL_UNIFORM_BUFFER: return 1;
+            case GL_TEXTURE_BUFFER: return 2;
+            case GL_PIXEL_UNPACK_BUFFER: return 3;
+            case GL_PIXEL_PACK_BUFFER: return 4;
+            case GL_COPY_READ_BUFFER: return 5;
+            case GL_COPY_WRITE_BUFFER: return 6;
+            case GL_DRAW_INDIRECT_BUFFER: return 7;
+            default: return -1;
+        }
+    }
+
+    static int textureSlot(GLenum target) {
+        switch (target) {
+            case GL_TEXTURE_2D: return 0;
+            case GL_TEXTURE_BUFFER: return 1;
+            default: return -1;
+        }
+    }
+
+    static int capabilitySlot(GLenum capability) {
+        switch (capability) {
+            case GL_DEPTH_TEST: return 0;
+            case GL_BLEND: return 1;
+            case GL_CULL_FACE: return 2;
+            case GL_SCISSOR_TEST: return 3;
+            default: return -1;
+        }
+    }
+
+    // records value as the new state and counts the call, returns false when it was already set
+    bool changed(unsigned int &state, unsigned int value) {
+        if (state == value) {
+            stats.elided++;
+            return false;
+        }
+        state = value;
+        stats.issued++;
+        return true;
+    }
+
+    void setCapability(GLenum capability, bool on) {
+        int slot = capabilitySlot(capability);
+        if (slot >= 0) {
+            if (capabilities[slot] == (int) on) {
+                stats.elided++;
+                return;
+            }
+            capabilities[slot] = (int) on;
+        }
+        stats.issued++;
+        if (on) glEnable(capability);
+        else glDisable(capability);
+    }
+
+    unsigned int program;
+    unsigned int vertexArray;
+    unsigned int drawFramebuffer;
+    unsigned int readFramebuffer;
+    unsigned int activeUnit;
+    unsigned int buffers[8];
+    unsigned int textures[GL_STATE_TEXTURE_UNITS][2];
+    unsigned int samplers[GL_STATE_TEXTURE_UNITS];
+    int capabilities[4];
+    unsigned int depthFunc;
+    int depthMask;
+    unsigned int blendSource;
+    unsigned int blendDestination;
+    unsigned int polygonMode;
+
+    GLStateStats stats;
+};
+
+// the engine has a single context, so a single cache shadows it
+inline GLStateCache &glState() {
+    static GLStateCache cache;
+    return cache;
+}
+
+#endif //GRAPHICS_ENGINE_GLFW_GL_STATE_CACHE_H
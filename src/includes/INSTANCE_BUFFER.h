@@ -0,0 +1,101 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_INSTANCE_BUFFER_H
+#define GRAPHICS_ENGINE_GLFW_INSTANCE_BUFFER_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+#include "RING_BUFFER.h"
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// attribute locations of the per-instance data, 0-2 are the mesh's position/normal/uv
+const unsigned int INSTANCE_MODEL_LOCATION = 3;  // mat4, takes locations 3-6
+const unsigned int INSTANCE_NORMAL_LOCATION = 7; // mat3, takes locations 7-9
+
+// per-instance vertex data read by the lit vertex shaders
+struct InstanceData {
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+};
+
+// buffer of per-instance transforms so every copy of a mesh is drawn with one glDrawArraysInstanced
+class InstanceBuffer {
+public:
+    // buffer id
+    unsigned int ID = 0;
+    unsigned int Count = 0;
+    // base instance to draw with, the instances' index in a ring buffer
+    unsigned int First = 0;
+
+    InstanceBuffer() {
+        glGenBuffers(1, &ID);
+    }
+
+    // instances rewritten every frame go through the ring buffer instead of a buffer of their own
+    explicit InstanceBuffer(RingBuffer &ring) : ID(ring.ID), ring(&ring) {}
+
+    InstanceBuffer(const InstanceBuffer &) = delete;
+    InstanceBuffer &operator=(const InstanceBuffer &) = delete;
+
+    ~InstanceBuffer() {
+        if (!ring) glState().deleteBuffers(1, &ID);
+    }
+
+    // adds the instance attributes to a vertex array, one buffer can be attached to several vertex arrays
+    void attach(unsigned int vertexArray) const {
+        glState().bindVertexArray(vertexArray);
+        glState().bindBuffer(GL_ARRAY_BUFFER, ID);
+
+        // a matrix attribute is fed one column per location
+        for (unsigned int column = 0; column < 4; column++) {
+            unsigned int location = INSTANCE_MODEL_LOCATION + column;
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *) (offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+
+        for (unsigned int column = 0; column < 3; column++) {
+            unsigned int location = INSTANCE_NORMAL_LOCATION + column;
+            glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *) (offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec3)));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+
+        glState().bindVertexArray(0);
+    }
+
+    // replaces the instance data. a buffer of its own only grows so updating with the same count never reallocates, a
+    // ring backed one is written to fresh space every frame and has to be updated before each frame's draws
+    void update(const std::vector<InstanceData> &instances) {
+        auto size = (GLsizeiptr) (instances.size() * sizeof(InstanceData));
+
+        // aligned to the struct size so the offset is a whole number of instances
+        if (ring) {
+            RingAllocation allocation = ring->write(instances.data(), (size_t) size, sizeof(InstanceData));
+            First = (unsigned int) (allocation.offset / sizeof(InstanceData));
+            Count = allocation.data ? (unsigned int) instances.size() : 0;
+            return;
+        }
+
+        glState().bindBuffer(GL_ARRAY_BUFFER, ID);
+        if (size > capacity) {
+            glBufferData(GL_ARRAY_BUFFER, size, instances.data(), GL_DYNAMIC_DRAW);
+            capacity = size;
+        } else if (size > 0) {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances.data());
+        }
+
+        Count = (unsigned int) instances.size();
+    }
+
+private:
+    RingBuffer *ring = nullptr;
+    GLsizeiptr capacity = 0;
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_INSTANCE_BUFFER_H
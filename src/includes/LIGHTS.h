@@ -0,0 +1,141 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_LIGHTS_H
+#define GRAPHICS_ENGINE_GLFW_LIGHTS_H
+
+#include <glm/glm.hpp>
+
+#include "UNIFORM_BUFFER.h"
+
+#include <cmath>
+#include <cstring>
+
+// std140 mirrors of the structs inside LightBlock, a vec3 takes 16 bytes unless a float follows it
+struct DirLightData {
+    glm::vec3 direction;
+    float padding0;
+    glm::vec3 ambient;
+    float padding1;
+    glm::vec3 diffuse;
+    float padding2;
+    glm::vec3 specular;
+    float padding3;
+};
+
+struct SpotLightData {
+    glm::vec3 position;
+    float cutOff;
+    glm::vec3 direction;
+    float outerCutOff;
+    glm::vec3 ambient;
+    float constant;
+    glm::vec3 diffuse;
+    float linear;
+    glm::vec3 specular;
+    float quadratic;
+    int lightOn;
+    int padding[3];
+};
+
+// point lights live in texture buffers, the block only describes the cluster grid they were sorted into
+struct ClusterGridData {
+    glm::uvec4 size;
+    glm::vec4 depthParams;
+    glm::vec4 tileSize;
+};
+
+struct LightBlockData {
+    DirLightData dirLight;
+    SpotLightData spotLight;
+    ClusterGridData clusterGrid;
+};
+
+static_assert(sizeof(DirLightData) == 64, "DirLight does not match the std140 layout");
+static_assert(sizeof(ClusterGridData) == 48, "ClusterGrid does not match the std140 layout");
+static_assert(sizeof(SpotLightData) == 96, "SpotLight does not match the std140 layout");
+
+// owns the LightBlock uniform buffer, setters only mark what changed and upload() sends the dirty bytes once per frame
+class LightBlock {
+public:
+    LightBlock() : buffer(sizeof(LightBlockData), LIGHT_BLOCK_BINDING) {
+        markDirty(0, sizeof(data));
+    }
+
+    void setDirLight(const glm::vec3 &direction, const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular) {
+        write(data.dirLight.direction, direction);
+        write(data.dirLight.ambient, ambient);
+        write(data.dirLight.diffuse, diffuse);
+        write(data.dirLight.specular, specular);
+    }
+
+    // describes the cluster grid for the shaders, only changes when the light count, projection or screen size does
+    void setClusterGrid(const glm::uvec3 &gridSize, unsigned int lightCount, float zNear, float zFar, int screenWidth, int screenHeight) {
+        // slice = log(depth) * scale + bias, the inverse of the exponential split used when building the clusters
+        float sliceScale = (float) gridSize.z / std::log(zFar / zNear);
+        float sliceBias = -sliceScale * std::log(zNear);
+
+        write(data.clusterGrid.size, glm::uvec4(gridSize.x, gridSize.y, gridSize.z, lightCount));
+        write(data.clusterGrid.depthParams, glm::vec4(zNear, zFar, sliceScale, sliceBias));
+        write(data.clusterGrid.tileSize, glm::vec4((float) screenWidth / (float) gridSize.x, (float) screenHeight / (float) gridSize.y, 0.0f, 0.0f));
+    }
+
+    void setSpotLight(const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular, float constant, float linear, float quadratic, float cutOff, float outerCutOff) {
+        SpotLightData &light = data.spotLight;
+        write(light.ambient, ambient);
+        write(light.diffuse, diffuse);
+        write(light.specular, specular);
+        write(light.constant, constant);
+        write(light.linear, linear);
+        write(light.quadratic, quadratic);
+        write(light.cutOff, cutOff);
+        write(light.outerCutOff, outerCutOff);
+    }
+
+    void setSpotLightTransform(const glm::vec3 &position, const glm::vec3 &direction) {
+        write(data.spotLight.position, position);
+        write(data.spotLight.direction, direction);
+    }
+
+    void setSpotLightOn(bool lightOn) {
+        write(data.spotLight.lightOn, (int) lightOn);
+    }
+
+    bool isSpotLightOn() const {
+        return data.spotLight.lightOn != 0;
+    }
+
+    // uploads the bytes changed since the last call, does nothing in the steady state
+    void upload() {
+        if (dirtyEnd <= dirtyBegin) return;
+
+        buffer.update(dirtyBegin, dirtyEnd - dirtyBegin, reinterpret_cast<const unsigned char *>(&data) + dirtyBegin);
+        dirtyBegin = sizeof(data);
+        dirtyEnd = 0;
+    }
+
+private:
+    UniformBuffer buffer;
+    LightBlockData data{};
+
+    // byte range of data that differs from the gpu copy
+    unsigned int dirtyBegin = sizeof(LightBlockData);
+    unsigned int dirtyEnd = 0;
+
+    template<typename T>
+    void write(T &field, const T &value) {
+        if (std::memcmp(&field, &value, sizeof(T)) == 0) return;
+
+        field = value;
+        auto offset = (unsigned int) (reinterpret_cast<unsigned char *>(&field) - reinterpret_cast<unsigned char *>(&data));
+        markDirty(offset, sizeof(T));
+    }
+
+    void markDirty(unsigned int offset, unsigned int size) {
+        if (offset < dirtyBegin) dirtyBegin = offset;
+        if (offset + size > dirtyEnd) dirtyEnd = offset + size;
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_LIGHTS_H
@@ -0,0 +1,172 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_PROGRAM_CACHE_H
+#define GRAPHICS_ENGINE_GLFW_PROGRAM_CACHE_H
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// linked program binaries stored on disk, keyed by the preprocessed shader sources and the driver that built them.
+// drivers are free to reject a binary at any time (driver update, different gpu), callers then compile from source
+class ProgramCache {
+public:
+    // shared by every Shader, the directory is created on the first store
+    static ProgramCache &global() {
+        static ProgramCache cache;
+        return cache;
+    }
+
+    void setDirectory(const std::string &path) {
+        directory = path;
+    }
+
+    void setEnabled(bool value) {
+        enabled = value;
+    }
+
+    // false when caching is off or the driver has no binary formats, Shader then never asks for a binary
+    bool isAvailable() {
+        if (!enabled) return false;
+
+        if (formatCount < 0) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        }
+
+        return formatCount > 0;
+    }
+
+    // hashes the sources together with the driver strings so a driver update never loads a stale binary
+    uint64_t makeKey(const std::string &vertexCode, const std::string &fragmentCode) {
+        if (driverString.empty()) {
+            driverString = glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' + glString(GL_VERSION);
+        }
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        hash = fnv1a(hash, driverString);
+        hash = fnv1a(hash, "\nvertex\n");
+        hash = fnv1a(hash, vertexCode);
+        hash = fnv1a(hash, "\nfragment\n");
+        hash = fnv1a(hash, fragmentCode);
+        return hash;
+    }
+
+    // loads a cached binary into program, returns false if there is none or the driver rejected it
+    bool load(unsigned int program, uint64_t key) {
+        std::ifstream file(entryPath(key), std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        auto fileSize = (uint64_t) file.tellg();
+        file.seekg(0);
+
+        EntryHeader header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file || header.magic != ENTRY_MAGIC || header.version != ENTRY_VERSION || header.key != key) return false;
+
+        // a truncated or corrupt entry is a miss, its size must not decide how much is allocated
+        if (header.size == 0 || header.size != fileSize - sizeof(header)) return false;
+
+        std::vector<char> binary(header.size);
+        file.read(binary.data(), (std::streamsize) binary.size());
+        if (!file) return false;
+
+        glProgramBinary(program, header.format, binary.data(), (GLsizei) binary.size());
+
+        int success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            std::cout << "SHADER::CACHE::BINARY_REJECTED: " << entryPath(key) << ", recompiling" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // writes the binary of a linked program, the program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    void store(unsigned int program, uint64_t key) {
+        int length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+
+        EntryHeader header{};
+        std::vector<char> binary(length);
+        glGetProgramBinary(program, length, &length, &header.format, binary.data());
+
+        header.magic = ENTRY_MAGIC;
+        header.version = ENTRY_VERSION;
+        header.size = (uint32_t) length;
+        header.key = key;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        // write next to the entry and rename, a crash mid-write never leaves a truncated binary behind
+        std::string path = entryPath(key);
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cout << "ERROR::SHADER::CACHE::WRITE_FAILED: " << tempPath << std::endl;
+                return;
+            }
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(binary.data(), length);
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::cout << "ERROR::SHADER::CACHE::WRITE_FAILED: " << path << " " << error.message() << std::endl;
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+
+private:
+    static constexpr uint32_t ENTRY_MAGIC = 0x43505242; // "BRPC"
+    static constexpr uint32_t ENTRY_VERSION = 1;
+    static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t version;
+        GLenum format;
+        uint32_t size;
+        uint64_t key;
+    };
+
+    std::string directory = "shader_cache";
+    std::string driverString;
+    int formatCount = -1;
+    bool enabled = true;
+
+    ProgramCache() = default;
+
+    std::string entryPath(uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) key);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    static std::string glString(GLenum name) {
+        const GLubyte *value = glGetString(name);
+        return value ? reinterpret_cast<const char *>(value) : "";
+    }
+
+    static uint64_t fnv1a(uint64_t hash, const std::string &data) {
+        for (unsigned char c: data) {
+            hash ^= c;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_PROGRAM_CACHE_H
@@ -0,0 +1,56 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_RENDER_TARGET_H
+#define GRAPHICS_ENGINE_GLFW_RENDER_TARGET_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+
+#include <iostream>
+
+// an offscreen stand in for the default framebuffer, for contexts that don't have one. same formats as a window's
+// back buffer, DEPTH24_STENCIL8 like the g-buffer so the scene depth can be blitted into it
+class RenderTarget {
+public:
+    // framebuffer id
+    unsigned int ID = 0;
+    unsigned int Color = 0; // RGBA8 renderbuffer
+    unsigned int Depth = 0; // DEPTH24_STENCIL8 renderbuffer
+    const int Width;
+    const int Height;
+
+    RenderTarget(int width, int height) : Width(width), Height(height) {
+        glGenRenderbuffers(1, &Color);
+        glBindRenderbuffer(GL_RENDERBUFFER, Color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        glGenRenderbuffers(1, &Depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, Depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &ID);
+        glState().bindFramebuffer(GL_FRAMEBUFFER, ID);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, Color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, Depth);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::RENDER_TARGET::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        }
+
+        glState().bindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    RenderTarget(const RenderTarget &) = delete;
+    RenderTarget &operator=(const RenderTarget &) = delete;
+
+    ~RenderTarget() {
+        glState().deleteFramebuffers(1, &ID);
+        glDeleteRenderbuffers(1, &Color);
+        glDeleteRenderbuffers(1, &Depth);
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_RENDER_TARGET_H
@@ -0,0 +1,184 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_RING_BUFFER_H
+#define GRAPHICS_ENGINE_GLFW_RING_BUFFER_H
+
+#include "glad/glad.h"
+#include "GL_EXTENSIONS.h"
+#include "GL_STATE_CACHE.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// how writes to a persistent mapping become visible to the gpu
+enum RingBufferMapping {
+    RING_BUFFER_COHERENT,      // visible as soon as they are written
+    RING_BUFFER_EXPLICIT_FLUSH // visible once flush() reports the written range to the driver
+};
+
+// space handed out for this frame, data is null when the frame's section is full
+struct RingAllocation {
+    void *data = nullptr;
+    size_t offset = 0; // from the start of the buffer, for attribute offsets, base instances and glBindBufferRange
+    size_t size = 0;
+};
+
+struct RingBufferStats {
+    size_t stalls = 0;      // frames that had to wait for the gpu to release their section
+    size_t peakBytes = 0;   // most bytes a single frame has used
+    size_t failedAllocations = 0;
+};
+
+// one buffer split into a section per frame in flight, the cpu writes this frame's section while the gpu still reads
+// the others. a fence after each frame's draws tells when a section can be written again, so there is no orphaning
+// and no implicit sync in the driver. with buffer storage the whole buffer stays mapped for its lifetime, without it
+// writes go to a staging copy that flush() uploads with glBufferSubData.
+//
+// per frame: beginFrame, allocate and write, flush before the draws that read it, endFrame after them
+class RingBuffer {
+public:
+    // buffer id
+    unsigned int ID = 0;
+    const size_t FrameSize; // bytes per section
+    const unsigned int Frames;
+    const RingBufferMapping Mapping;
+
+    explicit RingBuffer(size_t frameSize, unsigned int frames = 3, RingBufferMapping mapping = RING_BUFFER_COHERENT)
+            : FrameSize(alignUp(frameSize, SECTION_ALIGNMENT)), Frames(frames), Mapping(mapping), fences(frames, nullptr) {
+        auto size = (GLsizeiptr) (FrameSize * Frames);
+        glGenBuffers(1, &ID);
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, ID);
+
+        if (GLExtensions::global().bufferStorage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+            flags |= mapping == RING_BUFFER_COHERENT ? GL_MAP_COHERENT_BIT : 0;
+            GLExtensions::global().BufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+
+            flags |= mapping == RING_BUFFER_EXPLICIT_FLUSH ? GL_MAP_FLUSH_EXPLICIT_BIT : 0;
+            mapped = (unsigned char *) glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+            if (!mapped) std::cout << "ERROR::RING_BUFFER::PERSISTENT_MAP_FAILED: falling back to glBufferSubData" << std::endl;
+        }
+
+        if (!mapped) {
+            // buffer storage is immutable, a failed map needs a fresh buffer for glBufferData
+            if (GLExtensions::global().bufferStorage) {
+                glState().deleteBuffers(1, &ID);
+                glGenBuffers(1, &ID);
+                glState().bindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            }
+            glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            staging.resize(FrameSize);
+        }
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    ~RingBuffer() {
+        for (GLsync fence: fences) {
+            if (fence) glDeleteSync(fence);
+        }
+        // deleting the buffer unmaps it
+        glState().deleteBuffers(1, &ID);
+    }
+
+    bool isPersistent() const {
+        return mapped != nullptr;
+    }
+
+    // moves on to the next section, waiting for the gpu if it still reads what was written there Frames frames ago
+    void beginFrame() {
+        frame = (frame + 1) % Frames;
+        head = 0;
+        flushed = 0;
+
+        GLsync &fence = fences[frame];
+        if (!fence) return;
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            stats.stalls++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        if (result == GL_WAIT_FAILED) std::cout << "ERROR::RING_BUFFER::FENCE_WAIT_FAILED" << std::endl;
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // size bytes whose offset in the buffer is a multiple of alignment, which doesn't have to be a power of two so
+    // arrays of any struct can be addressed by index
+    RingAllocation allocate(size_t size, size_t alignment = 16) {
+        size_t base = FrameSize * frame;
+        size_t offset = alignUp(base + head, alignment);
+        if (offset + size > base + FrameSize) {
+            if (stats.failedAllocations++ == 0) {
+                std::cout << "ERROR::RING_BUFFER::OUT_OF_SPACE: " << size << " bytes don't fit in a " << FrameSize << " byte frame" << std::endl;
+            }
+            return {};
+        }
+
+        head = offset + size - base;
+        if (head > stats.peakBytes) stats.peakBytes = head;
+
+        unsigned char *data = mapped ? mapped + offset : staging.data() + (offset - base);
+        return {data, offset, size};
+    }
+
+    RingAllocation write(const void *source, size_t size, size_t alignment = 16) {
+        RingAllocation allocation = allocate(size, alignment);
+        if (allocation.data) std::memcpy(allocation.data, source, size);
+        return allocation;
+    }
+
+    // makes everything allocated since the last flush visible to the gpu, nothing to do for a coherent mapping
+    void flush() {
+        if (flushed == head) return;
+
+        size_t base = FrameSize * frame;
+        if (!mapped) {
+            glState().bindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) (base + flushed), (GLsizeiptr) (head - flushed), staging.data() + flushed);
+        } else if (Mapping == RING_BUFFER_EXPLICIT_FLUSH) {
+            glState().bindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr) (base + flushed), (GLsizeiptr) (head - flushed));
+        }
+        flushed = head;
+    }
+
+    // fences the section after the last draw reading it was submitted
+    void endFrame() {
+        flush();
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    const RingBufferStats &getStats() const {
+        return stats;
+    }
+
+private:
+    // keeps every section start aligned for any uniform buffer offset alignment a driver asks for
+    static const size_t SECTION_ALIGNMENT = 256;
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::vector<GLsync> fences;
+    unsigned char *mapped = nullptr;
+    std::vector<unsigned char> staging;
+
+    unsigned int frame = 0;
+    size_t head = 0;
+    size_t flushed = 0;
+    RingBufferStats stats;
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_RING_BUFFER_H
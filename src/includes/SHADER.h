@@ -1,132 +1,339 @@
-﻿//
-// Created by kira on 19/10/2023.
-//
-
-#ifndef GRAPHICS_ENGINE_GLFW_SHADER_H
-#define GRAPHICS_ENGINE_GLFW_SHADER_H
-
-#include "glad/glad.h"
-
-#include <c++/string>
-#include <c++/fstream>
-#include <c++/sstream>
-#include <c++/iostream>
-
-class Shader {
-public:
-    // program id
-    unsigned int ID;
-
-    // constructor: reads and builds the shader
-    Shader(const char *vertexPath, const char *fragmentPath) {
-        // 1. retrieve vertex/fragment source code from path
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-
-        // ensure ifstream objects can throw exceptions
-        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-        try {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream;
-            std::stringstream fShaderStream;
-
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-
-        } catch (std::ifstream::failure &e) {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
-
-        const char *vShaderCode = vertexCode.c_str();
-        const char *fShaderCode = fragmentCode.c_str();
-
-        // 2. compile shaders
-        unsigned int vertex;
-        unsigned int fragment;
-
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, nullptr);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-
-        // fragment shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, nullptr);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-
-        // shader program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-
-
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-    }
-
-    // use/activate shader
-    void use() {
-        glUseProgram(ID);
-    }
-
-    // utility uniform functions
-    void setBool(const std::string &name, bool value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int) value);
-    }
-    void setInt(const std::string &name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-    }
-    void setFloat(const std::string &name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
-    }
-    void setVec3(const std::string &name, const glm::vec3 &value) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-    }
-    void setVec3(const std::string &name, float x, float y, float z) const {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
-    }
-    void setMat4(const std::string &name, glm::mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-    }
-
-private:
-    static void checkCompileErrors(unsigned int shader, const std::string &type) {
-        int success;
-        char infoLog[1024];
-        if (type != "PROGRAM") {
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-            if (!success) {
-                glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        } else {
-            glGetProgramiv(shader, GL_LINK_STATUS, &success);
-            if (!success) {
-                glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
-                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        }
-    }
-};
-
-#endif //GRAPHICS_ENGINE_GLFW_SHADER_H
+//
+// Created by kira on 19/10/2023.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_SHADER_H
+#define GRAPHICS_ENGINE_GLFW_SHADER_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+#include <glm/glm.hpp>
+
+#include "PROGRAM_CACHE.h"
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+
+// index into a shader's reflected uniform table, resolve once with Shader::getUniform and reuse every frame
+typedef int UniformHandle;
+const UniformHandle INVALID_UNIFORM = -1;
+
+class Shader {
+public:
+    // program id
+    unsigned int ID;
+
+    // constructor: reads and builds the shader
+    Shader(const char *vertexPath, const char *fragmentPath) {
+        // 1. retrieve vertex/fragment source code from path, expanding #include directives. every file read gets a
+        // source string number, compile errors are reported as number(line)
+        std::vector<std::string> vertexFiles;
+        std::vector<std::string> fragmentFiles;
+        std::string vertexCode = readSource(vertexPath, vertexFiles);
+        std::string fragmentCode = readSource(fragmentPath, fragmentFiles);
+
+        // 2. try the driver's binary from a previous run, it is rejected if the sources or the driver changed
+        ProgramCache &cache = ProgramCache::global();
+        bool useCache = cache.isAvailable();
+        uint64_t cacheKey = useCache ? cache.makeKey(vertexCode, fragmentCode) : 0;
+
+        if (useCache) {
+            ID = glCreateProgram();
+            if (cache.load(ID, cacheKey)) {
+                reflectUniforms();
+                return;
+            }
+
+            // a rejected binary leaves the program in an undefined state, start over with a fresh one
+            glState().deleteProgram(ID);
+        }
+
+        const char *vShaderCode = vertexCode.c_str();
+        const char *fShaderCode = fragmentCode.c_str();
+
+        // 3. compile shaders
+        unsigned int vertex;
+        unsigned int fragment;
+
+        // vertex shader
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, nullptr);
+        glCompileShader(vertex);
+        checkCompileErrors(vertex, "VERTEX", &vertexFiles);
+
+        // fragment shader
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, nullptr);
+        glCompileShader(fragment);
+        checkCompileErrors(fragment, "FRAGMENT", &fragmentFiles);
+
+        // shader program
+        ID = glCreateProgram();
+        glAttachShader(ID, vertex);
+        glAttachShader(ID, fragment);
+        if (useCache) glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(ID);
+        if (checkCompileErrors(ID, "PROGRAM") && useCache) cache.store(ID, cacheKey);
+
+        reflectUniforms();
+
+        // delete the shaders as they're linked into our program now and no longer necessary
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+    }
+
+    // use/activate shader
+    void use() {
+        glState().useProgram(ID);
+    }
+
+    // returns the handle of an active uniform, or INVALID_UNIFORM if the program doesn't use it
+    UniformHandle getUniform(const std::string &name) const {
+        auto it = uniformHandles.find(name);
+        return it != uniformHandles.end() ? it->second : INVALID_UNIFORM;
+    }
+
+    // handle uniform functions, values are only sent to the driver when they differ from the last upload
+    void setBool(UniformHandle handle, bool value) {
+        setInt(handle, (int) value);
+    }
+    void setInt(UniformHandle handle, int value) {
+        if (shadowChanged(handle, &value, sizeof(value)))
+            glUniform1i(uniforms[handle].location, value);
+    }
+    void setFloat(UniformHandle handle, float value) {
+        if (shadowChanged(handle, &value, sizeof(value)))
+            glUniform1f(uniforms[handle].location, value);
+    }
+    void setVec2(UniformHandle handle, const glm::vec2 &value) {
+        if (shadowChanged(handle, &value[0], sizeof(value)))
+            glUniform2fv(uniforms[handle].location, 1, &value[0]);
+    }
+    void setVec3(UniformHandle handle, const glm::vec3 &value) {
+        if (shadowChanged(handle, &value[0], sizeof(value)))
+            glUniform3fv(uniforms[handle].location, 1, &value[0]);
+    }
+    void setVec3(UniformHandle handle, float x, float y, float z) {
+        setVec3(handle, glm::vec3(x, y, z));
+    }
+    void setMat4(UniformHandle handle, const glm::mat4 &mat) {
+        if (shadowChanged(handle, &mat[0][0], sizeof(mat)))
+            glUniformMatrix4fv(uniforms[handle].location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    // utility uniform functions, these hash the name on every call so prefer handles in the render loop
+    void setBool(const std::string &name, bool value) {
+        setBool(getUniform(name), value);
+    }
+    void setInt(const std::string &name, int value) {
+        setInt(getUniform(name), value);
+    }
+    void setFloat(const std::string &name, float value) {
+        setFloat(getUniform(name), value);
+    }
+    void setVec2(const std::string &name, const glm::vec2 &value) {
+        setVec2(getUniform(name), value);
+    }
+    void setVec3(const std::string &name, const glm::vec3 &value) {
+        setVec3(getUniform(name), value);
+    }
+    void setVec3(const std::string &name, float x, float y, float z) {
+        setVec3(getUniform(name), x, y, z);
+    }
+    void setMat4(const std::string &name, const glm::mat4 &mat) {
+        setMat4(getUniform(name), mat);
+    }
+
+private:
+    struct UniformSlot {
+        int location;
+        unsigned int shadowOffset;
+        unsigned int shadowSize;
+        bool uploaded;
+    };
+
+    // flat table of every active uniform, handles index into it
+    std::vector<UniformSlot> uniforms;
+    std::unordered_map<std::string, UniformHandle> uniformHandles;
+
+    // cpu copy of the last value uploaded for each uniform
+    std::vector<unsigned char> uniformShadow;
+
+    // queries all active uniforms once after linking so the setters never call glGetUniformLocation
+    void reflectUniforms() {
+        int count = 0;
+        int maxNameLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        std::vector<char> nameBuffer(maxNameLength + 1);
+
+        for (int i = 0; i < count; i++) {
+            int nameLength = 0;
+            int arraySize = 0;
+            GLenum type;
+            glGetActiveUniform(ID, i, (int) nameBuffer.size(), &nameLength, &arraySize, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), nameLength);
+
+            // arrays are reported once as "name[0]", register every element so "name[i]" resolves too
+            size_t bracket = name.rfind("[0]");
+            if (bracket != std::string::npos && bracket + 3 == name.size()) {
+                std::string baseName = name.substr(0, bracket);
+                for (int element = 0; element < arraySize; element++) {
+                    std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                    addUniform(elementName, type);
+                }
+                auto first = uniformHandles.find(name);
+                if (first != uniformHandles.end()) uniformHandles[baseName] = first->second;
+            } else {
+                addUniform(name, type);
+            }
+        }
+    }
+
+    void addUniform(const std::string &name, GLenum type) {
+        int location = glGetUniformLocation(ID, name.c_str());
+
+        // members of uniform blocks have no location and are not set through glUniform
+        if (location < 0) return;
+
+        UniformSlot slot{};
+        slot.location = location;
+        slot.shadowOffset = (unsigned int) uniformShadow.size();
+        slot.shadowSize = uniformTypeSize(type);
+        slot.uploaded = false;
+
+        uniformHandles[name] = (UniformHandle) uniforms.size();
+        uniforms.push_back(slot);
+        uniformShadow.resize(uniformShadow.size() + slot.shadowSize);
+    }
+
+    // compares a value against the shadow copy and records it, returns true if it needs uploading
+    bool shadowChanged(UniformHandle handle, const void *value, unsigned int size) {
+        if (handle < 0 || handle >= (UniformHandle) uniforms.size()) return false;
+
+        UniformSlot &slot = uniforms[handle];
+        unsigned char *shadow = &uniformShadow[slot.shadowOffset];
+        if (size > slot.shadowSize) size = slot.shadowSize;
+
+        if (slot.uploaded && std::memcmp(shadow, value, size) == 0) return false;
+
+        std::memcpy(shadow, value, size);
+        slot.uploaded = true;
+        return true;
+    }
+
+    static unsigned int uniformTypeSize(GLenum type) {
+        switch (type) {
+            case GL_FLOAT_VEC2:
+            case GL_INT_VEC2:
+            case GL_BOOL_VEC2:
+                return 8;
+            case GL_FLOAT_VEC3:
+            case GL_INT_VEC3:
+            case GL_BOOL_VEC3:
+                return 12;
+            case GL_FLOAT_VEC4:
+            case GL_INT_VEC4:
+            case GL_BOOL_VEC4:
+            case GL_FLOAT_MAT2:
+                return 16;
+            case GL_FLOAT_MAT3:
+                return 36;
+            case GL_FLOAT_MAT4:
+                return 64;
+            default:
+                // scalars, bools and samplers
+                return 4;
+        }
+    }
+
+    // reads a shader file and splices in any #include "file" lines, paths are relative to the including file. the
+    // path is appended to files, its index there is the source string number #line gives its lines
+    static std::string readSource(const std::string &path, std::vector<std::string> &files, int depth = 0) {
+        int sourceNumber = (int) files.size();
+        files.push_back(path);
+
+        std::string code;
+        std::ifstream shaderFile;
+
+        // ensure ifstream objects can throw exceptions
+        shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+        try {
+            shaderFile.open(path);
+            std::stringstream shaderStream;
+            shaderStream << shaderFile.rdbuf();
+            shaderFile.close();
+            code = shaderStream.str();
+        } catch (std::ifstream::failure &e) {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << " " << e.what() << std::endl;
+            return "";
+        }
+
+        // glsl compilers reject the utf-8 byte order mark, and an included one would land in the middle of the source
+        if (code.compare(0, 3, "\xEF\xBB\xBF") == 0) code.erase(0, 3);
+
+        std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+        std::stringstream codeStream(code);
+        std::string expanded;
+        std::string line;
+        int lineNumber = 0;
+
+        // the top level file starts with #version, which nothing may precede, and is source string 0 anyway
+        if (depth > 0) expanded += "#line 1 " + std::to_string(sourceNumber) + "\n";
+
+        while (std::getline(codeStream, line)) {
+            lineNumber++;
+
+            if (line.compare(0, 8, "#include") != 0) {
+                expanded += line;
+                expanded += '\n';
+                continue;
+            }
+
+            size_t open = line.find('"');
+            size_t close = line.find('"', open + 1);
+            if (open == std::string::npos || close == std::string::npos || depth > 16) {
+                std::cout << "ERROR::SHADER::INVALID_INCLUDE: " << path << ":" << lineNumber << " " << line << std::endl;
+                continue;
+            }
+
+            // included files guard themselves with #ifndef, the #line switches error messages back to this file
+            expanded += readSource(directory + line.substr(open + 1, close - open - 1), files, depth + 1);
+            expanded += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+        }
+
+        return expanded;
+    }
+
+    // prints the info log on failure, returns true if the shader compiled / the program linked. files maps the source
+    // string numbers in the log back to paths
+    static bool checkCompileErrors(unsigned int shader, const std::string &type, const std::vector<std::string> *files = nullptr) {
+        int success;
+        char infoLog[1024];
+        if (type != "PROGRAM") {
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
+                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog;
+                for (size_t i = 0; files && i < files->size(); i++) std::cout << "source " << i << ": " << (*files)[i] << "\n";
+                std::cout << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        } else {
+            glGetProgramiv(shader, GL_LINK_STATUS, &success);
+            if (!success) {
+                glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+        return success;
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_SHADER_H
@@ -0,0 +1,81 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_TEXTURE_H
+#define GRAPHICS_ENGINE_GLFW_TEXTURE_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+
+#include <atomic>
+#include <memory>
+
+// sampler and format settings a texture is created with, two loads of the same file only share a texture if these match
+struct TextureParams {
+    GLint wrapS = GL_REPEAT;
+    GLint wrapT = GL_REPEAT;
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLint magFilter = GL_LINEAR;
+    bool mipmaps = true;
+    bool srgb = false;
+
+    bool operator==(const TextureParams &other) const {
+        return wrapS == other.wrapS && wrapT == other.wrapT && minFilter == other.minFilter && magFilter == other.magFilter &&
+               mipmaps == other.mipmaps && srgb == other.srgb;
+    }
+};
+
+enum TextureState {
+    TEXTURE_LOADING,
+    TEXTURE_READY,
+    TEXTURE_FAILED
+};
+
+// 2D texture that may still be streaming in, id() hands out the fallback texture until every texel is uploaded
+class Texture {
+public:
+    // texture id
+    unsigned int ID = 0;
+    int Width = 0;
+    int Height = 0;
+    int Levels = 0;
+
+    explicit Texture(unsigned int fallback) : Fallback(fallback) {
+        glGenTextures(1, &ID);
+    }
+
+    Texture(const Texture &) = delete;
+    Texture &operator=(const Texture &) = delete;
+
+    ~Texture() {
+        glState().deleteTextures(1, &ID);
+    }
+
+    // the texture to bind this frame
+    unsigned int id() const {
+        return ready() ? ID : Fallback;
+    }
+
+    bool ready() const {
+        return State.load(std::memory_order_acquire) == TEXTURE_READY;
+    }
+
+    bool failed() const {
+        return State.load(std::memory_order_acquire) == TEXTURE_FAILED;
+    }
+
+    void setState(TextureState state) {
+        State.store(state, std::memory_order_release);
+    }
+
+private:
+    unsigned int Fallback;
+    std::atomic<TextureState> State{TEXTURE_LOADING};
+};
+
+// shared ownership of a texture, the GL object is deleted when the last handle goes away so handles must be
+// released on the GL thread
+typedef std::shared_ptr<Texture> TextureHandle;
+
+#endif //GRAPHICS_ENGINE_GLFW_TEXTURE_H
@@ -0,0 +1,44 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef GRAPHICS_ENGINE_GLFW_UNIFORM_BUFFER_H
+#define GRAPHICS_ENGINE_GLFW_UNIFORM_BUFFER_H
+
+#include "glad/glad.h"
+#include "GL_STATE_CACHE.h"
+
+// fixed binding points, these must match the layout(binding = N) of the blocks in src/shaders
+enum UniformBlockBinding {
+    LIGHT_BLOCK_BINDING = 0,
+    FRAME_CONSTANTS_BINDING = 1
+};
+
+class UniformBuffer {
+public:
+    // buffer id
+    unsigned int ID = 0;
+    unsigned int Size;
+
+    // allocates the buffer and attaches it to its binding point, every program declaring the block at that binding shares it
+    UniformBuffer(unsigned int size, unsigned int binding) : Size(size) {
+        glGenBuffers(1, &ID);
+        glState().bindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+        glState().bindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+    }
+
+    UniformBuffer(const UniformBuffer &) = delete;
+    UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+    ~UniformBuffer() {
+        glState().deleteBuffers(1, &ID);
+    }
+
+    void update(unsigned int offset, unsigned int size, const void *data) const {
+        glState().bindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    }
+};
+
+#endif //GRAPHICS_ENGINE_GLFW_UNIFORM_BUFFER_H
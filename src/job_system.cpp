@@ -0,0 +1,103 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "job_system.h"
+
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+}
+
+ThreadPool &ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)> &fn) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // chunks are claimed from a shared counter so fast threads pick up the slack of slow ones
+    struct Batch {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> finishedChunks{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto batch = std::make_shared<Batch>();
+
+    auto runChunks = [batch, count, grainSize, chunkCount, &fn]() {
+        size_t chunk;
+        while ((chunk = batch->nextChunk.fetch_add(1)) < chunkCount) {
+            size_t begin = chunk * grainSize;
+            size_t end = begin + grainSize < count ? begin + grainSize : count;
+            fn(begin, end);
+
+            if (batch->finishedChunks.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->done.notify_all();
+            }
+        }
+    };
+
+    // helpers that start after every chunk was claimed return without touching fn
+    size_t helpers = chunkCount - 1 < workers.size() ? chunkCount - 1 : workers.size();
+    for (size_t i = 0; i < helpers; i++) {
+        enqueue(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&batch, chunkCount]() { return batch->finishedChunks.load() == chunkCount; });
+}
@@ -0,0 +1,60 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_JOB_SYSTEM_H
+#define KIRA_SOURCE_JOB_SYSTEM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads shared by everything that wants to run work off the main thread
+class ThreadPool {
+public:
+    // threadCount 0 picks one worker per hardware thread minus the main thread
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool();
+
+    // the pool used by the engine's subsystems
+    static ThreadPool &global();
+
+    unsigned int getThreadCount() const {
+        return (unsigned int) workers.size();
+    }
+
+    // runs fn(begin, end) over [0, count) in chunks of grainSize, the calling thread helps and returns once every chunk ran
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)> &fn);
+
+    // queues a task and returns a future for its result
+    template<typename F>
+    auto submit(F &&fn) -> std::future<decltype(fn())> {
+        using Result = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        std::future<Result> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+};
+
+#endif //KIRA_SOURCE_JOB_SYSTEM_H
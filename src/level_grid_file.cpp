@@ -0,0 +1,141 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "level_grid_file.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+LevelParseResult cookLevelGrid(const std::string &textPath, const std::string &gridPath, int chunkSize) {
+    std::string tempPath = gridPath + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "ERROR::LEVEL::COOK_WRITE_FAILED: " << tempPath << std::endl;
+        return LevelParseResult();
+    }
+
+    // the header is rewritten once the size is known
+    KgridHeader header{};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // rows are collected into a band one chunk tall, each full band is written out chunk by chunk
+    std::vector<uint8_t> band;
+    size_t width = 0;
+    int bandRows = 0;
+    uint32_t chunkRows = 0;
+
+    auto flushBand = [&]() {
+        if (bandRows == 0) return;
+        size_t chunksX = (width + chunkSize - 1) / chunkSize;
+        std::vector<uint8_t> chunk((size_t) chunkSize * chunkSize);
+        for (size_t cx = 0; cx < chunksX; cx++) {
+            std::fill(chunk.begin(), chunk.end(), 0);
+            size_t columns = std::min((size_t) chunkSize, width - cx * chunkSize);
+            for (int row = 0; row < bandRows; row++) {
+                std::memcpy(&chunk[(size_t) row * chunkSize], &band[row * width + cx * chunkSize], columns);
+            }
+            file.write(reinterpret_cast<const char *>(chunk.data()), (std::streamsize) chunk.size());
+        }
+        bandRows = 0;
+        chunkRows++;
+    };
+
+    LevelParser parser;
+    LevelParseResult result = parser.parseFile(textPath, [&](size_t, const uint8_t *values, size_t count) {
+        if (width == 0) {
+            width = count;
+            band.resize(width * chunkSize);
+        }
+        std::memcpy(&band[(size_t) bandRows * width], values, count);
+        if (++bandRows == chunkSize) flushBand();
+    });
+    flushBand();
+
+    header.magic = KGRID_MAGIC;
+    header.version = KGRID_VERSION;
+    header.width = (uint32_t) result.columns;
+    header.height = (uint32_t) result.rows;
+    header.chunkSize = (uint32_t) chunkSize;
+    header.chunksX = (uint32_t) ((width + chunkSize - 1) / chunkSize);
+    header.chunksY = chunkRows;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+
+    std::error_code error;
+    if (!result.fileRead || !file) {
+        std::filesystem::remove(tempPath, error);
+        return result;
+    }
+
+    std::filesystem::rename(tempPath, gridPath, error);
+    if (error) std::cout << "ERROR::LEVEL::COOK_WRITE_FAILED: " << gridPath << " " << error.message() << std::endl;
+    return result;
+}
+
+bool levelGridOutOfDate(const std::string &textPath, const std::string &gridPath) {
+    std::error_code error;
+    auto gridTime = std::filesystem::last_write_time(gridPath, error);
+    if (error) return true;
+    auto textTime = std::filesystem::last_write_time(textPath, error);
+    return !error && textTime > gridTime;
+}
+
+bool LevelGridFile::open(const std::string &path) {
+    if (!file.open(path)) return false;
+
+    if (file.size() < sizeof(KgridHeader)) {
+        file.close();
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    // the chunks have to fit the level vertex decode, cover the level and be in the file, columnHeight only bounds
+    // checks against width and height. cellsX * cellsY could overflow, so it is compared against the data size by
+    // division
+    uint64_t cellsX = (uint64_t) header.chunksX * header.chunkSize;
+    uint64_t cellsY = (uint64_t) header.chunksY * header.chunkSize;
+    uint64_t dataSize = file.size() - sizeof(KgridHeader);
+    bool covered = header.width <= cellsX && header.height <= cellsY && (cellsX == 0 || cellsY <= dataSize / cellsX);
+    if (header.magic != KGRID_MAGIC || header.version != KGRID_VERSION || header.chunkSize == 0 || header.chunkSize > (uint32_t) KGRID_MAX_CHUNK_SIZE || !covered) {
+        std::cout << "ERROR::LEVEL::INVALID_GRID_FILE: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    return true;
+}
+
+int LevelGridFile::columnHeight(int x, int y) const {
+    if (x < 0 || y < 0 || x >= (int) header.width || y >= (int) header.height) return 0;
+
+    int chunkSize = (int) header.chunkSize;
+    size_t chunk = (size_t) (y / chunkSize) * header.chunksX + x / chunkSize;
+    size_t offset = sizeof(KgridHeader) + chunk * chunkSize * chunkSize + (size_t) (y % chunkSize) * chunkSize + x % chunkSize;
+    return file.data()[offset];
+}
+
+void LevelGridFile::readChunkWithBorder(int chunkX, int chunkY, uint8_t *out) const {
+    int chunkSize = (int) header.chunkSize;
+    int paddedSize = chunkSize + 2;
+    int baseX = chunkX * chunkSize;
+    int baseY = chunkY * chunkSize;
+
+    // the inside is copied a row at a time, only the border goes through the per-cell lookup
+    const uint8_t *chunk = file.data() + sizeof(KgridHeader) + ((size_t) chunkY * header.chunksX + chunkX) * chunkSize * chunkSize;
+    for (int y = -1; y <= chunkSize; y++) {
+        uint8_t *row = out + (size_t) (y + 1) * paddedSize;
+        if (y >= 0 && y < chunkSize) {
+            std::memcpy(row + 1, chunk + (size_t) y * chunkSize, chunkSize);
+            row[0] = (uint8_t) columnHeight(baseX - 1, baseY + y);
+            row[paddedSize - 1] = (uint8_t) columnHeight(baseX + chunkSize, baseY + y);
+        } else {
+            for (int x = -1; x <= chunkSize; x++) row[x + 1] = (uint8_t) columnHeight(baseX + x, baseY + y);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_LEVEL_GRID_FILE_H
+#define KIRA_SOURCE_LEVEL_GRID_FILE_H
+
+#include "mapped_file.h"
+#include "level_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// COOKED LEVEL GRID (.kgrid)
+// --------------------------
+// the level grid split into square chunks, each chunk's cells stored contiguously so loading a chunk touches only
+// its own pages of the mapped file. edge chunks are padded with empty cells.
+//
+//   KgridHeader
+//   chunk (0, 0), chunk (1, 0) ... chunk (chunksX - 1, chunksY - 1), chunkSize * chunkSize bytes each
+
+const uint32_t KGRID_MAGIC = 0x4452474B; // "KGRD"
+const uint32_t KGRID_VERSION = 1;
+// chunks are meshed in chunk local cell coordinates, which the level vertex decode stores up to
+// LEVEL_MAX_COORDINATE, so grids with bigger chunks are rejected when they are cooked or opened
+const int KGRID_MAX_CHUNK_SIZE = 256;
+
+struct KgridHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t chunkSize;
+    uint32_t chunksX;
+    uint32_t chunksY;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(KgridHeader) == 32, "KgridHeader must not contain padding");
+
+// converts a level text file into a .kgrid, streaming: only one band of chunkSize rows is held in memory
+LevelParseResult cookLevelGrid(const std::string &textPath, const std::string &gridPath, int chunkSize);
+
+// true if gridPath is missing or older than textPath
+bool levelGridOutOfDate(const std::string &textPath, const std::string &gridPath);
+
+// read-only view of a mapped .kgrid, safe to read from several threads at once
+class LevelGridFile {
+public:
+    bool open(const std::string &path);
+
+    int getWidth() const {
+        return (int) header.width;
+    }
+
+    int getHeight() const {
+        return (int) header.height;
+    }
+
+    int getChunkSize() const {
+        return (int) header.chunkSize;
+    }
+
+    int getChunksX() const {
+        return (int) header.chunksX;
+    }
+
+    int getChunksY() const {
+        return (int) header.chunksY;
+    }
+
+    // cells outside the level read as empty
+    int columnHeight(int x, int y) const;
+
+    // copies a chunk's cells plus a one cell border of its neighbours, row-major, (chunkSize + 2)^2 bytes
+    void readChunkWithBorder(int chunkX, int chunkY, uint8_t *out) const;
+
+private:
+    MappedFile file;
+    KgridHeader header{};
+};
+
+#endif //KIRA_SOURCE_LEVEL_GRID_FILE_H
@@ -0,0 +1,172 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "level_mesher.h"
+
+#include <algorithm>
+
+namespace {
+    // a quad's texture repeats along the world axes so tiling stays continuous across quads and regions
+    glm::vec2 faceTexCoords(const glm::vec3 &position, int axis) {
+        if (axis == 0) return {position.z, position.y};
+        if (axis == 1) return {position.x, position.z};
+        return {position.x, position.y};
+    }
+
+    void emitQuad(MeshData &mesh, int axis, bool positive, const glm::vec3 &corner, const glm::vec3 &du, const glm::vec3 &dv) {
+        glm::vec3 normal(0.0f);
+        normal[axis] = positive ? 1.0f : -1.0f;
+
+        // (corner, +du, +du+dv, +dv) winds counter clockwise seen from +axis, flip it for the negative faces
+        glm::vec3 corners[4] = {corner, corner + du, corner + du + dv, corner + dv};
+        if (!positive) std::swap(corners[1], corners[3]);
+
+        unsigned int base = (unsigned int) mesh.vertices.size();
+        for (const glm::vec3 &position: corners) {
+            mesh.vertices.push_back({position, normal, faceTexCoords(position, axis)});
+        }
+
+        const unsigned int quad[6] = {0, 1, 2, 0, 2, 3};
+        for (unsigned int index: quad) mesh.indices.push_back(base + index);
+    }
+}
+
+VertexDecode levelVertexDecode() {
+    // half floats are stored relative to the center of the range, keeping it at 0 keeps the integer corners exact
+    auto range = (float) LEVEL_MAX_COORDINATE;
+    return makeVertexDecode(LEVEL_VERTEX_FORMAT, glm::vec3(-range), glm::vec3(range), glm::vec2(0.0f), glm::vec2(range));
+}
+
+MeshData meshLevelRegion(const LevelGridView &grid, const LevelRegion &region) {
+    MeshData mesh;
+
+    // copy the region's heights with a one cell border of neighbours, the border hides faces against other regions
+    int paddedWidth = region.width + 2;
+    std::vector<uint8_t> heights((size_t) paddedWidth * (region.depth + 2));
+    int maxHeight = 0;
+    for (int y = -1; y <= region.depth; y++) {
+        for (int x = -1; x <= region.width; x++) {
+            int height = grid.columnHeight(region.x + x, region.y + y);
+            heights[(size_t) (y + 1) * paddedWidth + x + 1] = (uint8_t) height;
+
+            // the tallest column inside bounds the volume, nothing above it can be solid
+            if (x >= 0 && y >= 0 && x < region.width && y < region.depth) maxHeight = std::max(maxHeight, height);
+        }
+    }
+    if (maxHeight == 0) return mesh;
+
+    // volume axes: 0 = x (grid x), 1 = y (up), 2 = z (grid y)
+    const int size[3] = {region.width, maxHeight, region.depth};
+    auto solid = [&](int x, int y, int z) {
+        return y >= 0 && y < heights[(size_t) (z + 1) * paddedWidth + x + 1];
+    };
+
+    std::vector<unsigned char> mask;
+
+    for (int axis = 0; axis < 3; axis++) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        mask.assign((size_t) size[u] * size[v], 0);
+
+        for (int positive = 0; positive < 2; positive++) {
+            int step = positive ? 1 : -1;
+
+            for (int slice = 0; slice < size[axis]; slice++) {
+                // 1. mark the faces of this slice that look into empty space
+                for (int j = 0; j < size[v]; j++) {
+                    for (int i = 0; i < size[u]; i++) {
+                        int cell[3];
+                        cell[axis] = slice;
+                        cell[u] = i;
+                        cell[v] = j;
+                        int neighbour[3] = {cell[0], cell[1], cell[2]};
+                        neighbour[axis] += step;
+
+                        mask[(size_t) j * size[u] + i] = solid(cell[0], cell[1], cell[2]) && !solid(neighbour[0], neighbour[1], neighbour[2]);
+                    }
+                }
+
+                // 2. grow each marked face into the widest, then tallest, rectangle of marked faces
+                for (int j = 0; j < size[v]; j++) {
+                    for (int i = 0; i < size[u];) {
+                        if (!mask[(size_t) j * size[u] + i]) {
+                            i++;
+                            continue;
+                        }
+
+                        int width = 1;
+                        while (i + width < size[u] && mask[(size_t) j * size[u] + i + width]) width++;
+
+                        int height = 1;
+                        for (; j + height < size[v]; height++) {
+                            bool rowFull = true;
+                            for (int k = 0; k < width; k++) {
+                                if (!mask[(size_t) (j + height) * size[u] + i + k]) {
+                                    rowFull = false;
+                                    break;
+                                }
+                            }
+                            if (!rowFull) break;
+                        }
+
+                        for (int h = 0; h < height; h++) {
+                            std::fill_n(&mask[(size_t) (j + h) * size[u] + i], width, 0);
+                        }
+
+                        // 3. the quad lies on the far side of the cell for positive faces
+                        glm::vec3 corner(0.0f), du(0.0f), dv(0.0f);
+                        corner[axis] = (float) (slice + positive);
+                        corner[u] = (float) i;
+                        corner[v] = (float) j;
+                        du[u] = (float) width;
+                        dv[v] = (float) height;
+                        emitQuad(mesh, axis, positive, corner, du, dv);
+
+                        i += width;
+                    }
+                }
+            }
+        }
+    }
+
+    return mesh;
+}
+
+namespace {
+    // merges every step x step block into one column, as tall as its tallest or its lowest cell
+    MeshData meshBlocks(const LevelGridView &grid, const LevelRegion &region, int step, bool lowest) {
+        int coarseWidth = (region.width + step - 1) / step;
+        int coarseDepth = (region.depth + step - 1) / step;
+        std::vector<uint8_t> cells((size_t) coarseWidth * coarseDepth, lowest ? 255 : 0);
+        for (int y = 0; y < region.depth; y++) {
+            for (int x = 0; x < region.width; x++) {
+                uint8_t &cell = cells[(size_t) (y / step) * coarseWidth + x / step];
+                int height = grid.columnHeight(region.x + x, region.y + y);
+                cell = (uint8_t) (lowest ? std::min<int>(cell, height) : std::max<int>(cell, height));
+            }
+        }
+
+        MeshData mesh = meshLevelRegion(LevelGridView(cells.data(), coarseWidth, coarseDepth), LevelRegion{0, 0, coarseWidth, coarseDepth});
+
+        // back to full resolution cells, a partial block at the far edge is cut to the region
+        for (Vertex &vertex: mesh.vertices) {
+            vertex.position.x = std::min(vertex.position.x * (float) step, (float) region.width);
+            vertex.position.z = std::min(vertex.position.z * (float) step, (float) region.depth);
+            int axis = vertex.normal.x != 0.0f ? 0 : (vertex.normal.y != 0.0f ? 1 : 2);
+            vertex.texCoords = faceTexCoords(vertex.position, axis);
+        }
+
+        return mesh;
+    }
+}
+
+MeshData meshLevelRegionCoarse(const LevelGridView &grid, const LevelRegion &region, int step) {
+    if (step <= 1) return meshLevelRegion(grid, region);
+    return meshBlocks(grid, region, step, false);
+}
+
+MeshData meshLevelOccluder(const LevelGridView &grid, const LevelRegion &region, int step) {
+    if (step <= 1) return meshLevelRegion(grid, region);
+    return meshBlocks(grid, region, step, true);
+}
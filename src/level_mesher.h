@@ -0,0 +1,66 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_LEVEL_MESHER_H
+#define KIRA_SOURCE_LEVEL_MESHER_H
+
+#include <glm/glm.hpp>
+
+#include "level_parser.h"
+#include "mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+// rectangle of grid cells meshed together, x runs along world x and y along world z
+struct LevelRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int depth = 0;
+};
+
+// level meshes are in region-local cell units, half floats store those integer corners exactly so neighbouring
+// regions always meet without cracks
+const VertexFormat LEVEL_VERTEX_FORMAT = {PositionEncoding::HALF_FLOAT, NormalEncoding::OCTAHEDRAL16, TexCoordEncoding::UNORM16};
+
+// one decode for every level mesh so they can share a GeometryPool. texture coords are cell positions, they have to
+// stay below this many cells, which the tallest column (255) does and chunks are kept within
+const int LEVEL_MAX_COORDINATE = 256;
+VertexDecode levelVertexDecode();
+
+// looks up the grid cells a region is meshed from, cells outside the view read as empty
+struct LevelGridView {
+    const uint8_t *cells = nullptr;
+    int width = 0;
+    int height = 0;
+
+    explicit LevelGridView(const LevelGrid &grid) : cells(grid.cells.data()), width(grid.width), height(grid.height) {}
+    LevelGridView(const uint8_t *cells, int width, int height) : cells(cells), width(width), height(height) {}
+
+    // a cell's value is the height of the solid column standing on it
+    int columnHeight(int x, int y) const {
+        return x < 0 || y < 0 || x >= width || y >= height ? 0 : cells[(size_t) y * width + x];
+    }
+};
+
+// merges the visible faces of a region's columns into as few quads as possible. faces between two solid cells are
+// dropped, including across the region border, and coplanar neighbouring faces are grown into one rectangle
+// (greedy meshing). positions are in cells relative to the region's corner, texture coords repeat once per cell
+MeshData meshLevelRegion(const LevelGridView &grid, const LevelRegion &region);
+
+// detail levels of a streamed chunk: full detail, then blocks of 2x2 and 4x4 cells merged into one column
+const int LEVEL_LOD_COUNT = 3;
+
+// meshes the region with every step x step block of cells merged into one column as tall as the block's tallest.
+// neighbours outside the region are ignored, so the region's outer walls are always kept as skirts that hide the gaps
+// against finer neighbours. positions are in the same full resolution cell units as meshLevelRegion
+MeshData meshLevelRegionCoarse(const LevelGridView &grid, const LevelRegion &region, int step);
+
+// meshes the region with every step x step block of cells merged into one column as low as the block's lowest, a
+// few triangles that lie entirely inside the full detail solid. it can stand in for the region as an occluder without
+// ever hiding something that is visible, which the coarse detail levels would. same cell units as meshLevelRegion
+MeshData meshLevelOccluder(const LevelGridView &grid, const LevelRegion &region, int step);
+
+#endif //KIRA_SOURCE_LEVEL_MESHER_H
@@ -0,0 +1,229 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "level_parser.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KIRA_LEVEL_PARSER_SSE
+#endif
+
+namespace {
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    int countTrailingZeros(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(mask);
+#else
+        int count = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            count++;
+        }
+        return count;
+#endif
+    }
+}
+
+LevelParseResult LevelParser::parseFile(const std::string &path, const LevelRowSink &rowSink) {
+    LevelParseResult parseResult;
+    result = &parseResult;
+    sink = &rowSink;
+    lineNumber = 0;
+    row.clear();
+
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) return parseResult;
+    parseResult.fileRead = true;
+
+    // one chunk plus whatever partial line was left over from the previous one
+    std::vector<char> buffer(chunkSize);
+    size_t carried = 0;
+    bool firstChunk = true;
+
+    while (true) {
+        // a single line longer than the buffer grows it, every other chunk reuses the same memory
+        if (carried == buffer.size()) buffer.resize(buffer.size() * 2);
+
+        size_t read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+        parseResult.bytesRead += read;
+        size_t available = carried + read;
+        const char *data = buffer.data();
+        const char *end = data + available;
+        const char *lineStart = data;
+
+        if (firstChunk && available >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) lineStart += 3;
+        firstChunk = false;
+
+        while (const char *newline = static_cast<const char *>(std::memchr(lineStart, '\n', end - lineStart))) {
+            parseLine(lineStart, newline);
+            lineStart = newline + 1;
+        }
+
+        if (read == 0) {
+            // last line without a newline
+            if (lineStart < end) parseLine(lineStart, end);
+            break;
+        }
+
+        carried = (size_t) (end - lineStart);
+        std::memmove(buffer.data(), lineStart, carried);
+    }
+
+    std::fclose(file);
+    result = nullptr;
+    sink = nullptr;
+    return parseResult;
+}
+
+LevelParseResult LevelParser::parseFile(const std::string &path, LevelGrid &grid) {
+    grid = LevelGrid();
+
+    LevelParseResult parseResult = parseFile(path, [&grid](size_t, const uint8_t *values, size_t count) {
+        if (grid.height == 0) grid.width = (int) count;
+        grid.cells.insert(grid.cells.end(), values, values + count);
+        grid.height++;
+    });
+
+    return parseResult;
+}
+
+void LevelParser::parseLine(const char *begin, const char *end) {
+    lineNumber++;
+
+    // blank lines are skipped, they usually come from a trailing newline
+    const char *first = begin;
+    while (first < end && isBlank(*first)) first++;
+    if (first == end) return;
+
+    row.clear();
+    if (!tokenizeFast(begin, end)) {
+        row.clear();
+        tokenizeScalar(begin, end);
+    }
+    emitRow();
+}
+
+// fast path for the common case of single digit cells. every 16 bytes are classified at once and only the digits
+// and commas are visited. returns false for anything unusual (multi digit values, stray characters, empty cells),
+// the scalar path then handles the line and reports what is wrong with it
+bool LevelParser::tokenizeFast(const char *begin, const char *end) {
+#ifdef KIRA_LEVEL_PARSER_SSE
+    bool expectDigit = true;
+    bool previousWasDigit = false;
+    const __m128i zero = _mm_set1_epi8('0' - 1);
+    const __m128i nine = _mm_set1_epi8('9' + 1);
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+
+    for (const char *block = begin; block < end; block += 16) {
+        size_t length = (size_t) (end - block) < 16 ? (size_t) (end - block) : 16;
+
+        // the tail is copied into a blank-padded block rather than reading past the line
+        __m128i bytes;
+        if (length == 16) {
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        } else {
+            char tail[16];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, length);
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tail));
+        }
+
+        __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, zero), _mm_cmplt_epi8(bytes, nine));
+        __m128i commas = _mm_cmpeq_epi8(bytes, comma);
+        __m128i blanks = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)), _mm_cmpeq_epi8(bytes, carriageReturn));
+
+        unsigned int digitMask = (unsigned int) _mm_movemask_epi8(digits);
+        unsigned int commaMask = (unsigned int) _mm_movemask_epi8(commas);
+        unsigned int blankMask = (unsigned int) _mm_movemask_epi8(blanks);
+
+        // any byte that isn't a digit, comma or blank
+        if ((digitMask | commaMask | blankMask) != 0xFFFF) return false;
+        // two adjacent digits, inside the block or across the boundary
+        if ((digitMask & (digitMask << 1)) || (previousWasDigit && (digitMask & 1u))) return false;
+        previousWasDigit = (digitMask >> 15) & 1u;
+
+        // digits and commas have to alternate, blanks in between don't matter
+        unsigned int tokens = digitMask | commaMask;
+        while (tokens) {
+            int bit = countTrailingZeros(tokens);
+            bool isDigit = (digitMask >> bit) & 1u;
+            if (isDigit != expectDigit) return false;
+            if (isDigit) row.push_back((uint8_t) (block[bit] - '0'));
+            expectDigit = !isDigit;
+            tokens &= tokens - 1;
+        }
+    }
+
+    return !row.empty();
+#else
+    return false;
+#endif
+}
+
+void LevelParser::tokenizeScalar(const char *begin, const char *end) {
+    const char *cursor = begin;
+
+    while (true) {
+        const char *fieldEnd = static_cast<const char *>(std::memchr(cursor, ',', end - cursor));
+        bool lastField = fieldEnd == nullptr;
+        if (lastField) fieldEnd = end;
+
+        const char *first = cursor;
+        const char *last = fieldEnd;
+        while (first < last && isBlank(*first)) first++;
+        while (last > first && isBlank(*(last - 1))) last--;
+
+        if (first == last) {
+            // a trailing comma leaves one empty field at the end of the row, that one is fine
+            if (!lastField || row.empty()) {
+                report("empty cell " + std::to_string(row.size() + 1) + ", read as 0");
+                row.push_back(0);
+            }
+        } else {
+            unsigned int value = 0;
+            auto parsed = std::from_chars(first, last, value);
+            if (parsed.ec != std::errc() || parsed.ptr != last) {
+                report("invalid cell " + std::to_string(row.size() + 1) + " '" + std::string(first, last) + "', read as 0");
+                value = 0;
+            } else if (value > 255) {
+                report("cell " + std::to_string(row.size() + 1) + " value " + std::to_string(value) + " is out of range, clamped to 255");
+                value = 255;
+            }
+            row.push_back((uint8_t) value);
+        }
+
+        if (lastField) break;
+        cursor = fieldEnd + 1;
+    }
+}
+
+void LevelParser::emitRow() {
+    // the first row decides the width of the level
+    if (result->rows == 0) {
+        result->columns = row.size();
+    } else if (row.size() != result->columns) {
+        report("row has " + std::to_string(row.size()) + " cells, expected " + std::to_string(result->columns));
+        row.resize(result->columns, 0);
+    }
+
+    (*sink)(result->rows, row.data(), row.size());
+    result->rows++;
+}
+
+void LevelParser::report(const std::string &message) {
+    result->issueCount++;
+    if (result->issues.size() < LevelParseResult::MAX_REPORTED_ISSUES) {
+        result->issues.push_back({lineNumber, message});
+    }
+}
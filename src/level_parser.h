@@ -0,0 +1,84 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_LEVEL_PARSER_H
+#define KIRA_SOURCE_LEVEL_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// dense row-major grid of level cells, one byte per cell
+struct LevelGrid {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> cells;
+
+    uint8_t at(int x, int y) const {
+        return cells[(size_t) y * width + x];
+    }
+
+    // cells outside the grid read as empty
+    uint8_t get(int x, int y) const {
+        return x < 0 || y < 0 || x >= width || y >= height ? 0 : at(x, y);
+    }
+};
+
+// a problem found in the level file, parsing carries on past it
+struct LevelParseIssue {
+    size_t line;
+    std::string message;
+};
+
+struct LevelParseResult {
+    bool fileRead = false;
+    size_t rows = 0;
+    size_t columns = 0;
+    size_t bytesRead = 0;
+    size_t issueCount = 0;
+    // only the first MAX_REPORTED_ISSUES are kept, issueCount has the total
+    std::vector<LevelParseIssue> issues;
+
+    static constexpr size_t MAX_REPORTED_ISSUES = 64;
+
+    bool ok() const {
+        return fileRead && issueCount == 0;
+    }
+};
+
+// receives every parsed row as it is read, values holds one byte per cell
+typedef std::function<void(size_t row, const uint8_t *values, size_t count)> LevelRowSink;
+
+// streams a comma separated level grid from disk in fixed size chunks. rows are tokenized straight into bytes, the
+// text is never held in memory beyond the current chunk. tolerates a utf-8 bom, crlf line endings, spaces around
+// cells and a trailing comma; anything else is reported as an issue and the row is padded / truncated to the width
+// of the first row
+class LevelParser {
+public:
+    explicit LevelParser(size_t chunkSize = 64 * 1024) : chunkSize(chunkSize) {}
+
+    LevelParseResult parseFile(const std::string &path, const LevelRowSink &sink);
+
+    // parses into a dense grid
+    LevelParseResult parseFile(const std::string &path, LevelGrid &grid);
+
+private:
+    size_t chunkSize;
+
+    // per call state
+    LevelParseResult *result = nullptr;
+    const LevelRowSink *sink = nullptr;
+    std::vector<uint8_t> row;
+    size_t lineNumber = 0;
+
+    void parseLine(const char *begin, const char *end);
+    bool tokenizeFast(const char *begin, const char *end);
+    void tokenizeScalar(const char *begin, const char *end);
+    void emitRow();
+    void report(const std::string &message);
+};
+
+#endif //KIRA_SOURCE_LEVEL_PARSER_H
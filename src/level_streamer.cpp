@@ -0,0 +1,294 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "level_streamer.h"
+#include "level_mesher.h"
+#include "job_system.h"
+#include "transform.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static_assert(KGRID_MAX_CHUNK_SIZE <= LEVEL_MAX_COORDINATE, "cooked chunks must fit the level vertex decode");
+
+namespace {
+    // bookkeeping cost of a resident chunk, so empty chunks still count against the budget
+    const size_t CHUNK_OVERHEAD = 256;
+
+    // distance from a point to a chunk's footprint on the ground plane
+    float footprintDistance(const glm::vec2 &point, const glm::vec2 &minimum, const glm::vec2 &maximum) {
+        glm::vec2 closest = glm::clamp(point, minimum, maximum);
+        return glm::length(point - closest);
+    }
+}
+
+LevelStreamer::LevelStreamer(const std::string &gridPath, const LevelStreamerSettings &settings)
+        : settings(settings), geometry(LEVEL_VERTEX_FORMAT, levelVertexDecode()) {
+    open = grid.open(gridPath);
+    if (!open) {
+        std::cout << "ERROR::LEVEL::STREAMER_OPEN_FAILED: " << gridPath << std::endl;
+    }
+}
+
+LevelStreamer::~LevelStreamer() {
+    // jobs read from the mapped grid, let them finish before it goes away
+    for (PendingChunk &job: pending) job.mesh.wait();
+
+    for (auto &entry: chunks) release(entry.second);
+}
+
+void LevelStreamer::update(const glm::vec3 &cameraPosition, const glm::vec3 &cameraVelocity) {
+    if (!open) return;
+    frame++;
+
+    // 1. chunks around the camera and around where it is heading, nearest first
+    float chunkWorldSize = (float) grid.getChunkSize() * settings.cellSize;
+    glm::vec2 camera(cameraPosition.x - settings.origin.x, cameraPosition.z - settings.origin.z);
+    glm::vec2 predicted = camera + glm::vec2(cameraVelocity.x, cameraVelocity.z) * settings.prefetchSeconds;
+
+    glm::vec2 areaMin = glm::min(camera, predicted) - settings.loadRadius;
+    glm::vec2 areaMax = glm::max(camera, predicted) + settings.loadRadius;
+    int firstX = std::max(0, (int) std::floor(areaMin.x / chunkWorldSize));
+    int firstY = std::max(0, (int) std::floor(areaMin.y / chunkWorldSize));
+    int lastX = std::min(grid.getChunksX() - 1, (int) std::floor(areaMax.x / chunkWorldSize));
+    int lastY = std::min(grid.getChunksY() - 1, (int) std::floor(areaMax.y / chunkWorldSize));
+
+    std::vector<std::pair<float, uint64_t>> wanted;
+    for (int y = firstY; y <= lastY; y++) {
+        for (int x = firstX; x <= lastX; x++) {
+            glm::vec2 minimum = glm::vec2((float) x, (float) y) * chunkWorldSize;
+            glm::vec2 maximum = minimum + chunkWorldSize;
+            float distance = footprintDistance(camera, minimum, maximum);
+            float predictedDistance = footprintDistance(predicted, minimum, maximum);
+            if (distance > settings.loadRadius && predictedDistance > settings.loadRadius) continue;
+
+            // prefetched chunks queue behind the ones already in range
+            float priority = distance <= settings.loadRadius ? distance : settings.loadRadius + predictedDistance;
+            wanted.emplace_back(priority, chunkKey(x, y));
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+
+    std::vector<uint64_t> wantedKeys;
+    wantedKeys.reserve(wanted.size());
+    for (const auto &entry: wanted) wantedKeys.push_back(entry.second);
+
+    // 2. touch the resident ones and start meshing the missing ones on the thread pool
+    for (uint64_t key: wantedKeys) {
+        auto it = chunks.find(key);
+        if (it != chunks.end()) {
+            it->second.lastUsedFrame = frame;
+            continue;
+        }
+        if (pending.size() >= settings.maxJobsInFlight || isPending(key)) continue;
+
+        int chunkX = (int) (key >> 32);
+        int chunkY = (int) (uint32_t) key;
+        const LevelGridFile *source = &grid;
+        int occluderBlockSize = settings.occluderBlockSize;
+        pending.push_back({key, ThreadPool::global().submit([source, chunkX, chunkY, occluderBlockSize]() {
+            int chunkSize = source->getChunkSize();
+            std::vector<uint8_t> cells((size_t) (chunkSize + 2) * (chunkSize + 2));
+            source->readChunkWithBorder(chunkX, chunkY, cells.data());
+
+            // every detail level is meshed up front, the coarse ones are a fraction of the full one's cost
+            LevelGridView view(cells.data(), chunkSize + 2, chunkSize + 2);
+            ChunkMeshes meshes;
+            for (int level = 0; level < LEVEL_LOD_COUNT; level++) {
+                meshes.levels.push_back(meshLevelRegionCoarse(view, LevelRegion{1, 1, chunkSize, chunkSize}, 1 << level));
+            }
+            meshes.occluder = meshLevelOccluder(view, LevelRegion{1, 1, chunkSize, chunkSize}, occluderBlockSize);
+            return meshes;
+        })});
+        stats.loadsStarted++;
+    }
+
+    // 3. upload a bounded number of finished chunks so a burst of loads never stalls a frame
+    collectFinished();
+    size_t uploads = std::min<size_t>(readyKeys.size(), settings.maxUploadsPerFrame);
+    for (size_t i = 0; i < uploads; i++) upload(readyKeys[i], readyMeshes[i]);
+    readyKeys.erase(readyKeys.begin(), readyKeys.begin() + (long) uploads);
+    readyMeshes.erase(readyMeshes.begin(), readyMeshes.begin() + (long) uploads);
+
+    // 4. stay inside the memory budget
+    evict();
+
+    stats.residentChunks = chunks.size();
+}
+
+void LevelStreamer::selectLods(const glm::vec3 &cameraPosition, float fovY, float viewportHeight, float deltaTime) {
+    for (auto &entry: chunks) {
+        Chunk &chunk = entry.second;
+        if (!chunk.lods) continue;
+
+        glm::vec3 center = (chunk.boundsMin + chunk.boundsMax) * 0.5f;
+        float radius = glm::length(chunk.boundsMax - chunk.boundsMin) * 0.5f;
+        float pixelSize = projectedPixelSize(center, radius, cameraPosition, fovY, viewportHeight);
+        chunk.lods->update(chunk.lodState, pixelSize, deltaTime, settings.lod);
+    }
+}
+
+bool LevelStreamer::isPending(uint64_t key) const {
+    for (const PendingChunk &job: pending) {
+        if (job.key == key) return true;
+    }
+    return std::find(readyKeys.begin(), readyKeys.end(), key) != readyKeys.end();
+}
+
+void LevelStreamer::collectFinished() {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->mesh.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        readyKeys.push_back(it->key);
+        readyMeshes.push_back(it->mesh.get());
+        it = pending.erase(it);
+    }
+}
+
+void LevelStreamer::upload(uint64_t key, const ChunkMeshes &meshes) {
+    const MeshData &data = meshes.levels[0];
+
+    Chunk chunk;
+    chunk.lastUsedFrame = frame;
+    chunk.bytes = CHUNK_OVERHEAD;
+
+    // empty chunks stay resident without gpu buffers so they aren't meshed again every frame
+    if (!data.indices.empty()) {
+        int chunkX = (int) (key >> 32);
+        int chunkY = (int) (uint32_t) key;
+        float chunkWorldSize = (float) grid.getChunkSize() * settings.cellSize;
+
+        glm::vec3 chunkOrigin = settings.origin + glm::vec3((float) chunkX, 0.0f, (float) chunkY) * chunkWorldSize;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), chunkOrigin);
+        model = glm::scale(model, glm::vec3(settings.cellSize));
+        InstanceData instance{model, glm::mat3(1.0f)};
+        computeNormalMatrices(&instance, 1);
+
+        // every chunk lives in the one pool, so the visible ones are drawn with a few multi draws
+        chunk.lods = std::make_unique<LodGroup>();
+        for (int level = 0; level < LEVEL_LOD_COUNT; level++) {
+            float minPixelSize = level + 1 < LEVEL_LOD_COUNT ? settings.lodPixelSizes[level] : 0.0f;
+            chunk.lods->addLevel(geometry, meshes.levels[level], instance, minPixelSize);
+        }
+
+        // world bounds for frustum culling, the mesh positions are in cells relative to the chunk corner
+        glm::vec3 localMin = data.vertices[0].position;
+        glm::vec3 localMax = localMin;
+        for (const Vertex &vertex: data.vertices) {
+            localMin = glm::min(localMin, vertex.position);
+            localMax = glm::max(localMax, vertex.position);
+        }
+        chunk.boundsMin = chunkOrigin + localMin * settings.cellSize;
+        chunk.boundsMax = chunkOrigin + localMax * settings.cellSize;
+
+        // the full detail mesh is far too many triangles to rasterize on the cpu, the occluder is a few blocks that
+        // sit inside it
+        const MeshData &occluder = meshes.occluder;
+        chunk.occluderVertices.reserve(occluder.vertices.size());
+        for (const Vertex &vertex: occluder.vertices) chunk.occluderVertices.push_back(chunkOrigin + vertex.position * settings.cellSize);
+        chunk.occluderIndices = occluder.indices;
+
+        chunk.bytes += chunk.lods->getByteSize();
+        chunk.bytes += chunk.occluderVertices.size() * sizeof(glm::vec3) + chunk.occluderIndices.size() * sizeof(unsigned int);
+    }
+
+    stats.residentBytes += chunk.bytes;
+    stats.uploads++;
+    chunks[key] = std::move(chunk);
+}
+
+void LevelStreamer::evict() {
+    if (stats.residentBytes <= settings.memoryBudget) return;
+
+    // chunks still in range this frame are never evicted, even if they alone exceed the budget
+    std::vector<std::pair<uint64_t, uint64_t>> candidates;
+    for (const auto &entry: chunks) {
+        if (entry.second.lastUsedFrame != frame) candidates.emplace_back(entry.second.lastUsedFrame, entry.first);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto &candidate: candidates) {
+        if (stats.residentBytes <= settings.memoryBudget) break;
+
+        auto it = chunks.find(candidate.second);
+        stats.residentBytes -= it->second.bytes;
+        release(it->second);
+        chunks.erase(it);
+        stats.evictions++;
+    }
+
+    if (stats.residentBytes > settings.memoryBudget && !budgetWarningShown) {
+        std::cout << "WARNING::LEVEL::STREAMER_BUDGET: the chunks in range need " << stats.residentBytes << " bytes, over the budget of " << settings.memoryBudget << std::endl;
+        budgetWarningShown = true;
+    }
+}
+
+void LevelStreamer::release(Chunk &chunk) {
+    chunk.lods.reset();
+    chunk.occluderVertices = std::vector<glm::vec3>();
+    chunk.occluderIndices = std::vector<unsigned int>();
+}
+
+void LevelStreamer::cullChunks(const Frustum &frustum) const {
+    if (culledFrame == frame && std::memcmp(&culledFrustum, &frustum, sizeof(Frustum)) == 0) return;
+    culledFrame = frame;
+    culledFrustum = frustum;
+
+    drawBounds.clear();
+    drawChunks.clear();
+    for (const auto &entry: chunks) {
+        const Chunk &chunk = entry.second;
+        if (!chunk.lods) continue;
+        drawBounds.add(chunk.boundsMin, chunk.boundsMax);
+        drawChunks.push_back(&chunk);
+    }
+
+    cullBoxes(frustum, drawBounds, visibleChunks);
+}
+
+void LevelStreamer::addOccluders(OcclusionCuller &culler, const Frustum &frustum) const {
+    cullChunks(frustum);
+    for (uint32_t index: visibleChunks) {
+        const Chunk &chunk = *drawChunks[index];
+        culler.addOccluder(chunk.occluderVertices.data(), chunk.occluderVertices.size(), chunk.occluderIndices.data(), chunk.occluderIndices.size());
+    }
+}
+
+void LevelStreamer::submit(RenderQueue &queue, RenderPass pass, uint8_t shader, uint16_t material, const Frustum &frustum,
+                           const OcclusionCuller *occlusion) const {
+    cullChunks(frustum);
+    stats.drawnChunks = 0;
+    stats.occludedChunks = 0;
+    stats.drawnTriangles = 0;
+
+    for (uint32_t index: visibleChunks) {
+        const Chunk &chunk = *drawChunks[index];
+        if (occlusion && occlusion->isOccluded({chunk.boundsMin, chunk.boundsMax})) {
+            stats.occludedChunks++;
+            continue;
+        }
+        stats.drawnChunks++;
+
+        // while fading both levels are drawn with complementary dither patterns
+        const LodState &state = chunk.lodState;
+        const LodGroup &lods = *chunk.lods;
+        glm::vec3 center = (chunk.boundsMin + chunk.boundsMax) * 0.5f;
+        int level = std::max(state.level, 0);
+        float fade = state.previousLevel >= 0 ? std::max(state.fade, 1.0f / 64.0f) : 0.0f;
+
+        lods.submitLevel(queue, pass, shader, material, level, center, fade);
+        stats.drawnTriangles += lods.getIndexCount(level) / 3;
+
+        if (state.previousLevel >= 0) {
+            lods.submitLevel(queue, pass, shader, material, state.previousLevel, center, -fade);
+            stats.drawnTriangles += lods.getIndexCount(state.previousLevel) / 3;
+        }
+    }
+}
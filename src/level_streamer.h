@@ -0,0 +1,155 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_LEVEL_STREAMER_H
+#define KIRA_SOURCE_LEVEL_STREAMER_H
+
+#include <glm/glm.hpp>
+
+#include "culling.h"
+#include "geometry_pool.h"
+#include "level_grid_file.h"
+#include "level_mesher.h"
+#include "lod.h"
+#include "occlusion_culling.h"
+#include "render_queue.h"
+#include "mesh.h"
+#include "includes/INSTANCE_BUFFER.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LevelStreamerSettings {
+    glm::vec3 origin = glm::vec3(0.0f); // world position of the grid's (0, 0) corner
+    float cellSize = 1.0f;
+    float loadRadius = 96.0f;           // chunks whose footprint comes this close to the camera are loaded
+    float prefetchSeconds = 1.5f;       // also load around where the camera will be this far ahead
+    size_t memoryBudget = 64u << 20;    // bytes of chunk geometry kept resident, least recently used chunks go first
+    unsigned int maxUploadsPerFrame = 4;
+    unsigned int maxJobsInFlight = 8;
+
+    // projected height in pixels below which a chunk drops to the next coarser detail level
+    float lodPixelSizes[LEVEL_LOD_COUNT - 1] = {1000.0f, 500.0f};
+    LodSettings lod;
+
+    // occluders are meshed from blocks of this many cells, each as low as its lowest column, see meshLevelOccluder
+    int occluderBlockSize = 2;
+};
+
+struct LevelStreamerStats {
+    size_t residentChunks = 0;
+    size_t residentBytes = 0;
+    size_t loadsStarted = 0;
+    size_t uploads = 0;
+    size_t evictions = 0;
+    size_t drawnChunks = 0;    // chunks that passed the frustum and occlusion tests in the last submit
+    size_t occludedChunks = 0; // chunks in the frustum but hidden in the last submit
+    size_t drawnTriangles = 0;
+};
+
+// streams a cooked level grid around the camera: chunks are read from the mapped file and greedy meshed on the
+// thread pool, uploaded a few per frame, and evicted least recently used first once the memory budget is exceeded
+class LevelStreamer {
+public:
+    LevelStreamer(const std::string &gridPath, const LevelStreamerSettings &settings);
+
+    LevelStreamer(const LevelStreamer &) = delete;
+    LevelStreamer &operator=(const LevelStreamer &) = delete;
+
+    ~LevelStreamer();
+
+    bool isOpen() const {
+        return open;
+    }
+
+    // true when every chunk the last update wanted is resident
+    bool idle() const {
+        return pending.empty() && readyMeshes.empty();
+    }
+
+    const LevelGridFile &getGrid() const {
+        return grid;
+    }
+
+    // call once per frame on the GL thread before drawing
+    void update(const glm::vec3 &cameraPosition, const glm::vec3 &cameraVelocity);
+
+    // picks every resident chunk's detail level from its size on screen, fovY in degrees like Camera::Zoom
+    void selectLods(const glm::vec3 &cameraPosition, float fovY, float viewportHeight, float deltaTime);
+
+    // queues the occluder of every resident chunk in the frustum, call before rasterizing the culler
+    void addOccluders(OcclusionCuller &culler, const Frustum &frustum) const;
+
+    // queues a draw of every resident chunk that touches the frustum and isn't hidden behind the occluders, the
+    // shader must read the per-instance model matrix
+    void submit(RenderQueue &queue, RenderPass pass, uint8_t shader, uint16_t material, const Frustum &frustum,
+                const OcclusionCuller *occlusion = nullptr) const;
+
+    const LevelStreamerStats &getStats() const {
+        return stats;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<LodGroup> lods;
+        LodState lodState;
+        glm::vec3 boundsMin = glm::vec3(0.0f); // world space
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        std::vector<glm::vec3> occluderVertices; // world space occluder mesh for the occlusion culler
+        std::vector<unsigned int> occluderIndices;
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    // what a meshing job hands back, detail levels finest first
+    struct ChunkMeshes {
+        std::vector<MeshData> levels;
+        MeshData occluder;
+    };
+
+    struct PendingChunk {
+        uint64_t key;
+        std::future<ChunkMeshes> mesh;
+    };
+
+    LevelGridFile grid;
+    LevelStreamerSettings settings;
+    bool open = false;
+    bool budgetWarningShown = false;
+
+    // declared before the chunks, whose meshes it holds
+    GeometryPool geometry;
+    std::unordered_map<uint64_t, Chunk> chunks;
+    std::vector<PendingChunk> pending;
+    std::vector<ChunkMeshes> readyMeshes;
+    std::vector<uint64_t> readyKeys;
+    mutable LevelStreamerStats stats;
+    uint64_t frame = 0;
+
+    // scratch space for culling, kept around so drawing doesn't allocate every frame. addOccluders and submit see the
+    // same frustum, the chunks are only culled again once update has run or the frustum changes
+    mutable BoundingBoxes drawBounds;
+    mutable std::vector<const Chunk *> drawChunks;
+    mutable std::vector<uint32_t> visibleChunks;
+    mutable Frustum culledFrustum{};
+    mutable uint64_t culledFrame = UINT64_MAX;
+
+    static uint64_t chunkKey(int x, int y) {
+        return (uint64_t) (uint32_t) x << 32 | (uint32_t) y;
+    }
+
+    bool isPending(uint64_t key) const;
+    void collectFinished();
+    void upload(uint64_t key, const ChunkMeshes &meshes);
+    void evict();
+    void release(Chunk &chunk);
+    void cullChunks(const Frustum &frustum) const;
+};
+
+#endif //KIRA_SOURCE_LEVEL_STREAMER_H
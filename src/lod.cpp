@@ -0,0 +1,119 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "lod.h"
+#include "includes/GL_STATE_CACHE.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+
+float projectedPixelSize(const glm::vec3 &center, float radius, const glm::vec3 &cameraPosition, float fovY, float viewportHeight) {
+    float distance = glm::length(center - cameraPosition);
+
+    // the camera is inside the sphere, it covers the whole screen
+    if (distance <= radius) return INFINITY;
+
+    // diameter over the height of the view at that distance
+    return radius * viewportHeight / (distance * std::tan(glm::radians(fovY) * 0.5f));
+}
+
+LodGroup::~LodGroup() {
+    for (Level &level: levels) {
+        if (level.pool) level.pool->remove(level.geometry);
+        else glState().deleteVertexArrays(1, &level.vertexArray);
+    }
+}
+
+void LodGroup::addLevel(const MeshData &data, const VertexFormat &format, float minPixelSize) {
+    Level level;
+    level.mesh = std::make_unique<Mesh>(data, format);
+    level.vertexArray = level.mesh->createVertexArray();
+    level.minPixelSize = minPixelSize;
+    levels.push_back(std::move(level));
+}
+
+void LodGroup::addLevel(GeometryPool &pool, const MeshData &data, const InstanceData &instance, float minPixelSize) {
+    Level level;
+    level.pool = &pool;
+    level.geometry = pool.add(data, instance);
+    level.minPixelSize = minPixelSize;
+    levels.push_back(std::move(level));
+}
+
+void LodGroup::attach(const InstanceBuffer &instances) {
+    this->instances = &instances;
+    for (const Level &level: levels) {
+        if (!level.pool) instances.attach(level.vertexArray);
+    }
+}
+
+unsigned int LodGroup::getIndexCount(int level) const {
+    const Level &entry = levels[level];
+    return entry.pool ? entry.pool->getRange(entry.geometry).indexCount : entry.mesh->IndexCount;
+}
+
+void LodGroup::submitLevel(RenderQueue &queue, RenderPass pass, uint8_t shader, uint16_t material, int level,
+                           const glm::vec3 &center, float lodFade) const {
+    const Level &entry = levels[level];
+    if (entry.pool) {
+        queue.submit(pass, shader, material, *entry.pool, entry.geometry, center, lodFade);
+    } else if (instances) {
+        queue.submit(pass, shader, material, entry.vertexArray, *entry.mesh, instances->First, instances->Count, center, lodFade);
+    }
+}
+
+size_t LodGroup::getByteSize() const {
+    size_t bytes = 0;
+    for (const Level &level: levels) {
+        if (level.pool) bytes += level.pool->getByteSize(level.geometry);
+        else bytes += (size_t) level.mesh->VertexCount * level.mesh->Stride + (size_t) level.mesh->IndexCount * sizeof(unsigned int);
+    }
+    return bytes;
+}
+
+int LodGroup::selectLevel(float pixelSize, int currentLevel, float hysteresis) const {
+    int last = (int) levels.size() - 1;
+    if (last < 0) return -1;
+
+    // first selection, no band to respect
+    if (currentLevel < 0 || currentLevel > last) {
+        int level = 0;
+        while (level < last && pixelSize < levels[level].minPixelSize) level++;
+        return level;
+    }
+
+    // level i hands over to i + 1 below its minPixelSize, so the threshold between them is levels[i].minPixelSize
+    int level = currentLevel;
+    while (level < last && pixelSize < levels[level].minPixelSize * (1.0f - hysteresis)) level++;
+    while (level > 0 && pixelSize >= levels[level - 1].minPixelSize * (1.0f + hysteresis)) level--;
+    return level;
+}
+
+void LodGroup::update(LodState &state, float pixelSize, float deltaTime, const LodSettings &settings) const {
+    int level = selectLevel(pixelSize, state.level, settings.hysteresis);
+
+    if (state.level < 0 || settings.fadeSeconds <= 0.0f) {
+        state.level = level;
+        state.previousLevel = -1;
+        state.fade = 1.0f;
+        return;
+    }
+
+    // a change in the middle of a fade drops the level that was fading out
+    if (level != state.level) {
+        state.previousLevel = state.level;
+        state.level = level;
+        state.fade = 0.0f;
+    }
+
+    if (state.previousLevel >= 0) {
+        state.fade += deltaTime / settings.fadeSeconds;
+        if (state.fade >= 1.0f) {
+            state.fade = 1.0f;
+            state.previousLevel = -1;
+        }
+    }
+}
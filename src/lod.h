@@ -0,0 +1,87 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_LOD_H
+#define KIRA_SOURCE_LOD_H
+
+#include <glm/glm.hpp>
+
+#include "geometry_pool.h"
+#include "mesh.h"
+#include "render_queue.h"
+#include "includes/INSTANCE_BUFFER.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct LodSettings {
+    float hysteresis = 0.15f; // how far past a threshold, as a fraction of it, the size has to go before the level changes
+    float fadeSeconds = 0.3f; // length of the dithered cross-fade between two levels, 0 switches at once
+};
+
+// per object selection, kept between frames so the hysteresis and the fades have something to work from
+struct LodState {
+    int level = -1;         // -1 until the first selection
+    int previousLevel = -1; // level fading out, -1 when not fading
+    float fade = 1.0f;      // how far the current level has faded in
+};
+
+// height in pixels of a bounding sphere on screen, fovY is the vertical field of view in degrees like Camera::Zoom
+float projectedPixelSize(const glm::vec3 &center, float radius, const glm::vec3 &cameraPosition, float fovY, float viewportHeight);
+
+// several detail levels of one mesh, finest first. each level is used while the object is at least its minPixelSize
+// tall on screen, the last level regardless
+class LodGroup {
+public:
+    LodGroup() = default;
+
+    LodGroup(const LodGroup &) = delete;
+    LodGroup &operator=(const LodGroup &) = delete;
+
+    ~LodGroup();
+
+    void addLevel(const MeshData &data, const VertexFormat &format, float minPixelSize);
+
+    // a level stored in a shared pool instead of buffers of its own, instance is the transform it is drawn with
+    void addLevel(GeometryPool &pool, const MeshData &data, const InstanceData &instance, float minPixelSize);
+
+    // adds the instance attributes to the vertex array of every level with buffers of its own, they are drawn with
+    // these instances
+    void attach(const InstanceBuffer &instances);
+
+    size_t getLevelCount() const {
+        return levels.size();
+    }
+
+    unsigned int getIndexCount(int level) const;
+
+    // queues a draw of one level, lodFade is passed on to the shader (see shaders/common/lod_fade.glsl)
+    void submitLevel(RenderQueue &queue, RenderPass pass, uint8_t shader, uint16_t material, int level,
+                     const glm::vec3 &center, float lodFade) const;
+
+    // gpu bytes of every level's vertices and indices
+    size_t getByteSize() const;
+
+    // level for an object of the given size, only moving away from currentLevel once the size is clearly past the
+    // threshold between them so an object sitting on a threshold doesn't flicker between two levels
+    int selectLevel(float pixelSize, int currentLevel, float hysteresis) const;
+
+    // selects the level for this frame and advances the cross-fade, a change of level starts a new fade
+    void update(LodState &state, float pixelSize, float deltaTime, const LodSettings &settings) const;
+
+private:
+    struct Level {
+        std::unique_ptr<Mesh> mesh;
+        unsigned int vertexArray = 0;
+        GeometryPool *pool = nullptr;
+        int32_t geometry = -1;
+        float minPixelSize = 0.0f;
+    };
+
+    std::vector<Level> levels;
+    const InstanceBuffer *instances = nullptr;
+};
+
+#endif //KIRA_SOURCE_LOD_H
@@ -1,4 +1,4 @@
-﻿#define GLFW_INCLUDE_NONE
+#define GLFW_INCLUDE_NONE
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -9,11 +9,45 @@
 #include "includes/SHADER.h"
 #include "includes/INPUT.h"
 #include "includes/CAMERA.h"
-#include "level_editor.h"
-
+#include "includes/LIGHTS.h"
+#include "includes/FRAME_CONSTANTS.h"
+#include "includes/INSTANCE_BUFFER.h"
+#include "includes/GBUFFER.h"
+#include "includes/GL_STATE_CACHE.h"
+#include "includes/GL_EXTENSIONS.h"
+#include "includes/RING_BUFFER.h"
+#include "aabb_tree.h"
+#include "culling.h"
+#include "level_streamer.h"
+#include "occlusion_culling.h"
+#include "render_queue.h"
+#include "transform.h"
+#include "mesh.h"
+#include "clustered_lighting.h"
+#include "texture_loader.h"
+#include "texture_cache.h"
+#include "headless_context.h"
+#include "frame_timer.h"
+#include "includes/RENDER_TARGET.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 const unsigned int ASPECT_RATIO[] = {16, 9};
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 400.0f;
+// bytes of per frame gpu data (frame constants, streamed instances), three frames of it are in flight
+const size_t FRAME_RING_SIZE = 4 << 20;
+
+// current framebuffer size, the light cluster tiles are laid out in pixels
+int framebufferWidth = 0;
+int framebufferHeight = 0;
 
 // TIMING
 // ------
@@ -34,6 +68,37 @@ glm::vec3 lightDir(-0.2f, -1.0f, -0.3f);
 // plane
 glm::vec3 planePos(0.0f, -0.6f, 0.0f);
 
+// level, each grid cell is a column of LEVEL_CELL_SIZE cubes stacked as high as the cell's value
+glm::vec3 levelOrigin(-8.0f, -4.0f, -17.0f);
+const float LEVEL_CELL_SIZE = 4.0f;
+const int LEVEL_REGION_SIZE = 32;
+const char *LEVEL_PATH = "../../resources/level.txt";
+const char *LEVEL_GRID_PATH = "../../resources/level.kgrid";
+
+// BENCHMARK
+// ---------
+// timed runs fly a fixed camera path at a fixed time step, so every run renders the same frames
+const float BENCHMARK_TIME_STEP = 1.0f / 60.0f;
+const float BENCHMARK_TURN_RATE = 30.0f; // degrees of yaw per second
+const int BENCHMARK_DEFAULT_FRAMES = 600;
+// warm up lasts until the level and the textures are streamed in, or this many frames if they never are
+const int BENCHMARK_MAX_WARMUP_FRAMES = 10000;
+
+// set from the command line, see parseOptions
+struct EngineOptions {
+    bool headless = false; // render offscreen through EGL, no window or display needed
+    int frames = 0;        // timed frames before exiting with their statistics, 0 runs until the window is closed
+    int warmupFrames = 60; // untimed frames before the timed ones
+    int width = 1280;      // headless framebuffer size, a window is sized from the monitor
+    int height = 720;
+    std::string levelPath = LEVEL_PATH;
+    std::string levelGridPath = LEVEL_GRID_PATH;
+};
+
+bool parseOptions(int argc, char **argv, EngineOptions &options);
+int runEngine(GLFWwindow *window, const EngineOptions &options);
+void printFrameTimes(const char *name, const std::vector<double> &times);
+
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 void error_callback(int error, const char *description);
@@ -41,14 +106,51 @@ void mouse_callback(GLFWwindow *window, double xposIn, double yposIn);
 void scroll_callback(GLFWwindow *window, double xOffset, double yOffset);
 void processInput(GLFWwindow *window);
 void setWireframeMode(int wireframeOn);
-unsigned int loadTexture(const char *path);
 
 bool wireframeModeOn = false;
 
-int main() {
+// forward shades every rasterized fragment, deferred writes a g-buffer first and shades each visible pixel once
+enum RenderMode {
+    FORWARD_RENDERING,
+    DEFERRED_RENDERING
+};
+
+RenderMode renderMode = FORWARD_RENDERING;
+
+int main(int argc, char **argv) {
+    EngineOptions options;
+    if (!parseOptions(argc, argv, options)) return -1;
+
+    // the level is cooked into a chunked binary grid once, after that it is streamed from the mapped file
+    if (levelGridOutOfDate(options.levelPath, options.levelGridPath)) {
+        LevelParseResult cooked = cookLevelGrid(options.levelPath, options.levelGridPath, LEVEL_REGION_SIZE);
+        if (!cooked.fileRead) {
+            std::cout << "ERROR::LEVEL::FILE_NOT_SUCCESSFULLY_READ: " << options.levelPath << std::endl;
+        }
+        for (const LevelParseIssue &issue: cooked.issues) {
+            std::cout << "WARNING::LEVEL::PARSE: " << options.levelPath << ":" << issue.line << " " << issue.message << std::endl;
+        }
+    }
+
+    // HEADLESS
+    // --------
+    // no window and no display, frames are rendered into an offscreen target
+    if (options.headless) {
+        HeadlessContext context;
+        if (!context.create()) return -1;
+
+        if (!gladLoadGLLoader(HeadlessContext::getProcAddress)) {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
+        GLExtensions::global().load(HeadlessContext::getProcAddress);
 
-    LevelEditor *level = new LevelEditor("../../resources/level.txt");
-    std::cout << "Level\n\n" << *level->getLevelCode() << "\n";
+        framebufferWidth = options.width;
+        framebufferHeight = options.height;
+
+        // everything the engine made is deleted when it returns, before the context goes away
+        return runEngine(nullptr, options);
+    }
 
     // GLFW INIT
     // --------
@@ -71,7 +173,6 @@ int main() {
     // WINDOW HINTS
     // -----------
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
@@ -83,7 +184,12 @@ int main() {
 #endif
 
     // Create Window
-    GLFWwindow *window = glfwCreateWindow(SCRN_WDITH, SCRN_HEIGHT, "KIRλ SOURCE", nullptr, nullptr);
+    // ask for the newest context first, 4.3 brings multi draw indirect and 4.4 buffer storage. 4.2 is all that's needed
+    GLFWwindow *window = nullptr;
+    for (int minor = 6; minor >= 2 && window == nullptr; minor--) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+        window = glfwCreateWindow(SCRN_WDITH, SCRN_HEIGHT, "KIRλ SOURCE", nullptr, nullptr);
+    }
     if (window == nullptr) {
         std::cout << "Failed to create glfw window!" << std::endl;
         glfwTerminate();
@@ -97,7 +203,8 @@ int main() {
 
     // set callbacks
     glfwSetKeyCallback(window, key_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
+    // timed runs fly their own camera path
+    if (options.frames == 0) glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
@@ -123,13 +230,71 @@ int main() {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    GLExtensions::global().load((GLADloadproc) glfwGetProcAddress);
+
+    framebufferWidth = SCRN_WDITH;
+    framebufferHeight = SCRN_HEIGHT;
+
+    // everything the engine made is deleted when it returns, before the context goes away
+    int result = runEngine(window, options);
+
+    glfwTerminate();
+    return result;
+}
+
+// --headless             render offscreen through EGL, implies --frames 600 unless given
+// --frames N             exit after N timed frames and print their cpu and gpu frame time statistics
+// --warmup N             untimed frames first, at least until the level and textures are streamed in (default 60)
+// --size WIDTHxHEIGHT    headless framebuffer size (default 1280x720)
+// --deferred             start in deferred instead of forward rendering
+// --level PATH           level.txt to render, cooked to a .kgrid next to it
+bool parseOptions(int argc, char **argv, EngineOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--deferred") {
+            renderMode = DEFERRED_RENDERING;
+        } else if (argument == "--frames" && value) {
+            options.frames = std::atoi(value);
+            i++;
+        } else if (argument == "--warmup" && value) {
+            options.warmupFrames = std::atoi(value);
+            i++;
+        } else if (argument == "--size" && value && std::sscanf(value, "%dx%d", &options.width, &options.height) == 2) {
+            i++;
+        } else if (argument == "--level" && value) {
+            options.levelPath = value;
+            options.levelGridPath = options.levelPath.substr(0, options.levelPath.find_last_of('.')) + ".kgrid";
+            i++;
+        } else {
+            std::cout << "ERROR::OPTIONS::INVALID_ARGUMENT: " << argument << "\n"
+                      << "usage: [--headless] [--frames N] [--warmup N] [--size WIDTHxHEIGHT] [--deferred] [--level PATH]" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.width <= 0 || options.height <= 0 || options.frames < 0 || options.warmupFrames < 0) {
+        std::cout << "ERROR::OPTIONS::INVALID_VALUE: sizes and frame counts can't be negative" << std::endl;
+        return false;
+    }
 
-    glViewport(0, 0, SCRN_WDITH, SCRN_HEIGHT);
+    if (options.headless && options.frames == 0) options.frames = BENCHMARK_DEFAULT_FRAMES;
+    return true;
+}
+
+// sets up the scene and runs the render loop on the current context, window is null when rendering headless
+int runEngine(GLFWwindow *window, const EngineOptions &options) {
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
 
-    glEnable(GL_DEPTH_TEST);
+    glState().enable(GL_DEPTH_TEST);
 
     Shader diffuseLitShader("../../src/shaders/lit/diffuse_lit_vertex.glsl", "../../src/shaders/lit/diffuse_lit_fragment.glsl");
     Shader lightingShader("../../src/shaders/lit/basic_lit_vertex.glsl", "../../src/shaders/lit/basic_lit_fragment.glsl");
+    Shader gBufferShader("../../src/shaders/lit/diffuse_lit_vertex.glsl", "../../src/shaders/deferred/gbuffer_fragment.glsl");
+    Shader deferredLightingShader("../../src/shaders/deferred/deferred_lighting_vertex.glsl", "../../src/shaders/deferred/deferred_lighting_fragment.glsl");
 
     // -------------------- SHADER COMPILATION END---------------------------
     // @formatter:off
@@ -184,9 +349,6 @@ int main() {
 
     // @formatter:on
 
-    unsigned int VBO;
-    unsigned int cubeVAO;
-
     // positions of the point lights
     glm::vec3 pointLightPositions[] = {
             glm::vec3(0.7f, 0.2f, 2.0f),
@@ -195,39 +357,45 @@ int main() {
             glm::vec3(0.0f, 0.0f, -3.0f)
     };
 
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &VBO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindVertexArray(cubeVAO);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) nullptr);
-    glEnableVertexAttribArray(0);
-
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // texture attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-
-    // second, configure the light's VAO (VBO stays the same; the vertices are the same for the light object which is also a 3D cube)
-    unsigned int lightCubeVAO;
-    glGenVertexArrays(1, &lightCubeVAO);
-    glBindVertexArray(lightCubeVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) nullptr);
-    glEnableVertexAttribArray(0);
-
-    unsigned int diffuseMap = loadTexture("../../resources/textures/container2.png");
-    unsigned int specularMap = loadTexture("../../resources/textures/container2_specular.png");
+    // weld the 36 cube corners into an indexed mesh and order it for the vertex cache
+    MeshData cubeData = weldVertices(vertices, 36);
+    optimizeMesh(cubeData, "cube");
+    // positions, normals and uvs are quantized to 16 bytes per vertex, the shaders decode them with these uniforms
+    Mesh cubeMesh(cubeData);
+
+    unsigned int cubeVAO = cubeMesh.createVertexArray();
+
+    // level chunks around the camera are greedy meshed on worker threads, one draw per chunk at the detail level its
+    // size on screen calls for
+    LevelStreamerSettings levelSettings;
+    levelSettings.origin = levelOrigin;
+    levelSettings.cellSize = LEVEL_CELL_SIZE;
+    // distant chunks drop to coarser detail levels, so the level can be streamed out to the far plane
+    levelSettings.loadRadius = FAR_PLANE;
+    LevelStreamer levelStreamer(options.levelGridPath, levelSettings);
+    std::cout << "Level: " << levelStreamer.getGrid().getWidth() << "x" << levelStreamer.getGrid().getHeight() << " cells\n";
+    glm::vec3 lastCameraPosition = camera.Position;
+
+    // second, configure the light's VAO (the mesh stays the same; the light object is also a 3D cube)
+    unsigned int lightCubeVAO = cubeMesh.createVertexArray();
+
+    // textures decode on worker threads and stream in over the first frames, a grey placeholder is bound until then
+    TextureLoader textureLoader;
+    // materials request textures through the cache so a file used by several of them is only loaded once
+    TextureCache textureCache(textureLoader);
+    TextureHandle diffuseMap = textureCache.get("../../resources/textures/container2.png");
+    TextureHandle specularMap = textureCache.get("../../resources/textures/container2_specular.png");
+
+    // data rewritten every frame is streamed through a persistently mapped ring buffer guarded by fences
+    RingBuffer frameRing(FRAME_RING_SIZE);
+
+    // every draw goes through the render queue, sorted so draws sharing a shader and material are submitted together.
+    // runs of pooled draws are merged into multi draws whose commands are written to the ring
+    RenderQueue renderQueue(&frameRing);
+    uint8_t diffuseLitShaderId = renderQueue.addShader(diffuseLitShader);
+    uint8_t lightingShaderId = renderQueue.addShader(lightingShader);
+    uint8_t gBufferShaderId = renderQueue.addShader(gBufferShader);
+    uint16_t containerMaterial = renderQueue.addMaterial({diffuseMap, specularMap});
 
     glm::vec3 cubePositions[] = {
             glm::vec3(0.0f, 0.0f, 0.0f),
@@ -242,146 +410,278 @@ int main() {
             glm::vec3(-1.3f, 1.0f, -1.5f)
     };
 
+    // both paths sample the same material, diffuse map on unit 0 and specular map on unit 1
+    for (Shader *shader: {&diffuseLitShader, &gBufferShader}) {
+        shader->use();
+        shader->setInt("material.diffuse", 0);
+        shader->setInt("material.specular", 1);
+        shader->setFloat("material.shininess", 32.0f);
+    }
+
+    // deferred render targets, the lighting pass draws a fullscreen triangle generated in the vertex shader
+    GBuffer gBuffer(framebufferWidth, framebufferHeight);
+    unsigned int fullscreenVAO;
+    glGenVertexArrays(1, &fullscreenVAO);
+
+    // all light data lives in one uniform buffer shared by every lit shader, it is only rewritten when a light changes
+    LightBlock lightBlock;
+
+    // directional light
+    lightBlock.setDirLight(glm::vec3(-0.2f, -1.0f, -0.3f), glm::vec3(0.05f), glm::vec3(0.4f), glm::vec3(0.5f));
+
+    // point lights are sorted into a grid of clusters over the view frustum, fragments only shade their cluster's lights
+    std::vector<PointLight> pointLights;
+    for (const glm::vec3 &position: pointLightPositions) {
+        pointLights.push_back({position, glm::vec3(0.05f), glm::vec3(0.8f), glm::vec3(1.0f), 1.0f, 0.09f, 0.032f});
+    }
+
+    LightClusters lightClusters;
+    ClusteredLightBuffers clusteredLightBuffers;
+    clusteredLightBuffers.uploadLights(pointLights);
+
+    // spotLight
+    lightBlock.setSpotLightOn(false);
+    lightBlock.setSpotLight(glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.0f), 1.0f, 0.09f, 0.032f, glm::cos(glm::radians(12.5f)), glm::cos(glm::radians(15.0f)));
+
+    // view, projection and camera position are shared by every shader through one uniform buffer
+    FrameConstants frameConstants(frameRing);
+
+    // every copy of a mesh is drawn in one call, the transforms live in per-instance attribute buffers
+    std::vector<InstanceData> instances;
+    for (unsigned int i = 0; i < 10; i++) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        float angle = 20.0f * i;
+        model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        instances.push_back({model, glm::mat3(1.0f)});
+    }
+
+    computeNormalMatrices(instances.data(), instances.size());
+
+    // the cubes live in the scene's bounding volume tree, every frame only the ones in the frustum are copied into
+    // the instance buffer. a unit cube fits in a box of half size sqrt(3) / 2 whatever its rotation
+    std::vector<InstanceData> cubeInstanceData = instances;
+    AabbTree sceneTree;
+    std::vector<Aabb> cubeBounds;
+    for (uint32_t i = 0; i < cubeInstanceData.size(); i++) {
+        glm::vec3 center = glm::vec3(cubeInstanceData[i].model[3]);
+        cubeBounds.push_back({center - glm::vec3(0.8660254f), center + glm::vec3(0.8660254f)});
+        sceneTree.insert(cubeBounds.back(), i);
+    }
+    sceneTree.rebuild();
+
+    // the level is rasterized on the cpu every frame and whatever is hidden behind it is skipped
+    OcclusionCuller occlusionCuller;
+    std::vector<uint32_t> visibleCubes;
+    std::vector<InstanceData> visibleCubeInstances;
+
+    // the visible cubes change every frame, so their instances are streamed
+    InstanceBuffer cubeInstances(frameRing);
+    cubeInstances.attach(cubeVAO);
+
+    // we draw as many light bulbs as we have point lights.
+    instances.clear();
+    for (unsigned int i = 0; i < 4; i++) { // NOLINT(*-loop-convert)
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, pointLightPositions[i]);
+        model = glm::scale(model, glm::vec3(0.2f)); // Make it a smaller cube
+        instances.push_back({model, glm::mat3(1.0f)});
+    }
+
+    computeNormalMatrices(instances.data(), instances.size());
+
+    InstanceBuffer lightCubeInstances;
+    lightCubeInstances.update(instances);
+    lightCubeInstances.attach(lightCubeVAO);
+
+    // without a window the frames go to an offscreen target of the same size
+    std::unique_ptr<RenderTarget> offscreenTarget;
+    if (window == nullptr) offscreenTarget = std::make_unique<RenderTarget>(framebufferWidth, framebufferHeight);
+    unsigned int outputFramebuffer = offscreenTarget ? offscreenTarget->ID : 0;
+
+    // the aspect ratio is fixed at startup, the window keeps it when resized
+    const float aspectRatio = (float) framebufferWidth / (float) framebufferHeight;
+
+    // timed runs keep every frame's cpu time and, a few frames later, its gpu time
+    bool benchmark = options.frames > 0;
+    GpuFrameTimer gpuTimer;
+    std::vector<double> cpuFrameTimes;
+    std::vector<double> gpuFrameTimes;
+    int warmupFrames = 0;
+    int timedFrames = 0;
+
     // RENDER LOOP :3
     // --------------
-    while (!glfwWindowShouldClose(window)) {
+    while (window == nullptr || !glfwWindowShouldClose(window)) {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        // the first frame is always untimed, it pays for one off driver work and some drivers time their first query wrong
+        bool warmingUp = benchmark && warmupFrames < BENCHMARK_MAX_WARMUP_FRAMES &&
+                         (warmupFrames < std::max(options.warmupFrames, 1) || !levelStreamer.idle() || !textureLoader.idle());
+        if (benchmark && !warmingUp && timedFrames == 0) {
+            if (warmupFrames == BENCHMARK_MAX_WARMUP_FRAMES) std::cout << "WARNING::BENCHMARK::STILL_STREAMING: timing frames anyway" << std::endl;
+
+            // the warm up frames' gpu times are still coming back, they must not be counted as timed ones
+            std::vector<double> warmupTimes;
+            gpuTimer.collect(warmupTimes, true);
+        }
 
         // DELTA TIME
         // ----------
-        float currentFrame = static_cast<float>(glfwGetTime());
+        float currentFrame = benchmark ? (float) (warmupFrames + timedFrames) * BENCHMARK_TIME_STEP : static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // state calls are counted per frame, F2 prints the count so far
+        glState().resetStats();
+
         // INPUT
-        processInput(window);
+        if (!benchmark) {
+            processInput(window);
+        } else if (!warmingUp) {
+            camera.ProcessMouseMovement(BENCHMARK_TURN_RATE * deltaTime / camera.MouseSensitivity, 0.0f);
+        }
+
+        // finish any texture decodes and upload the next slice of texels
+        textureLoader.update();
+
+        // load level chunks around the camera and ahead of where it is moving
+        glm::vec3 cameraVelocity = deltaTime > 0.0f ? (camera.Position - lastCameraPosition) / deltaTime : glm::vec3(0.0f);
+        lastCameraPosition = camera.Position;
+        levelStreamer.update(camera.Position, cameraVelocity);
+        levelStreamer.selectLods(camera.Position, camera.Zoom, (float) framebufferHeight, deltaTime);
 
         // RENDER
         // ------
+        frameRing.beginFrame();
+        if (benchmark) gpuTimer.begin();
+        glState().bindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // be sure to activate shader when setting uniforms/drawing objects
-        diffuseLitShader.use();
-        diffuseLitShader.setVec3("viewPos", camera.Position);
-        diffuseLitShader.setFloat("material.shininess", 32.0f);
-
-        /*
-           Here we set all the uniforms for the 5/6 types of lights we have. We have to set them manually and index 
-           the proper PointLight struct in the array to set each uniform variable. This can be done more code-friendly
-           by defining light types as classes and set their values in there, or by using a more efficient uniform approach
-           by using 'Uniform buffer objects', but that is something we'll discuss in the 'Advanced GLSL' tutorial.
-        */
-        // directional light
-        diffuseLitShader.setVec3("dirLight.direction", -0.2f, -1.0f, -0.3f);
-        diffuseLitShader.setVec3("dirLight.ambient", 0.05f, 0.05f, 0.05f);
-        diffuseLitShader.setVec3("dirLight.diffuse", 0.4f, 0.4f, 0.4f);
-        diffuseLitShader.setVec3("dirLight.specular", 0.5f, 0.5f, 0.5f);
-        // point light 1
-        diffuseLitShader.setVec3("pointLights[0].position", pointLightPositions[0]);
-        diffuseLitShader.setVec3("pointLights[0].ambient", 0.05f, 0.05f, 0.05f);
-        diffuseLitShader.setVec3("pointLights[0].diffuse", 0.8f, 0.8f, 0.8f);
-        diffuseLitShader.setVec3("pointLights[0].specular", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setFloat("pointLights[0].constant", 1.0f);
-        diffuseLitShader.setFloat("pointLights[0].linear", 0.09f);
-        diffuseLitShader.setFloat("pointLights[0].quadratic", 0.032f);
-        // point light 2
-        diffuseLitShader.setVec3("pointLights[1].position", pointLightPositions[1]);
-        diffuseLitShader.setVec3("pointLights[1].ambient", 0.05f, 0.05f, 0.05f);
-        diffuseLitShader.setVec3("pointLights[1].diffuse", 0.8f, 0.8f, 0.8f);
-        diffuseLitShader.setVec3("pointLights[1].specular", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setFloat("pointLights[1].constant", 1.0f);
-        diffuseLitShader.setFloat("pointLights[1].linear", 0.09f);
-        diffuseLitShader.setFloat("pointLights[1].quadratic", 0.032f);
-        // point light 3
-        diffuseLitShader.setVec3("pointLights[2].position", pointLightPositions[2]);
-        diffuseLitShader.setVec3("pointLights[2].ambient", 0.05f, 0.05f, 0.05f);
-        diffuseLitShader.setVec3("pointLights[2].diffuse", 0.8f, 0.8f, 0.8f);
-        diffuseLitShader.setVec3("pointLights[2].specular", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setFloat("pointLights[2].constant", 1.0f);
-        diffuseLitShader.setFloat("pointLights[2].linear", 0.09f);
-        diffuseLitShader.setFloat("pointLights[2].quadratic", 0.032f);
-        // point light 4
-        diffuseLitShader.setVec3("pointLights[3].position", pointLightPositions[3]);
-        diffuseLitShader.setVec3("pointLights[3].ambient", 0.05f, 0.05f, 0.05f);
-        diffuseLitShader.setVec3("pointLights[3].diffuse", 0.8f, 0.8f, 0.8f);
-        diffuseLitShader.setVec3("pointLights[3].specular", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setFloat("pointLights[3].constant", 1.0f);
-        diffuseLitShader.setFloat("pointLights[3].linear", 0.09f);
-        diffuseLitShader.setFloat("pointLights[3].quadratic", 0.032f);
-        // spotLight
-        diffuseLitShader.setBool("spotLight.lightOn", false);
-        diffuseLitShader.setVec3("spotLight.position", camera.Position);
-        diffuseLitShader.setVec3("spotLight.direction", camera.Front);
-        diffuseLitShader.setVec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
-        diffuseLitShader.setVec3("spotLight.diffuse", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setVec3("spotLight.specular", 1.0f, 1.0f, 1.0f);
-        diffuseLitShader.setFloat("spotLight.constant", 1.0f);
-        diffuseLitShader.setFloat("spotLight.linear", 0.09f);
-        diffuseLitShader.setFloat("spotLight.quadratic", 0.032f);
-        diffuseLitShader.setFloat("spotLight.cutOff", glm::cos(glm::radians(12.5f)));
-        diffuseLitShader.setFloat("spotLight.outerCutOff", glm::cos(glm::radians(15.0f)));
-
         // view / projection transformations
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float) SCRN_WDITH / (float) SCRN_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 view = camera.GetViewMatrix();
-        diffuseLitShader.setMat4("projection", projection);
-        diffuseLitShader.setMat4("view", view);
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio, NEAR_PLANE, FAR_PLANE);
+        frameConstants.update(camera, projection, currentFrame);
+
+        // frustum cull the cubes and pack the survivors into the instance buffer
+        Frustum frustum = extractFrustum(frameConstants.get().viewProjection);
+        visibleCubes.clear();
+        sceneTree.queryFrustum(frustum, visibleCubes);
+
+        occlusionCuller.beginFrame(frameConstants.get().viewProjection);
+        levelStreamer.addOccluders(occlusionCuller, frustum);
+        occlusionCuller.rasterize();
+        occlusionCuller.removeOccluded(cubeBounds.data(), visibleCubes);
+        visibleCubeInstances.clear();
+        glm::vec3 visibleCubesCenter(0.0f);
+        for (uint32_t index: visibleCubes) {
+            visibleCubeInstances.push_back(cubeInstanceData[index]);
+            visibleCubesCenter += cubeBounds[index].center();
+        }
+        if (!visibleCubes.empty()) visibleCubesCenter /= (float) visibleCubes.size();
+        cubeInstances.update(visibleCubeInstances);
+        frameRing.flush();
+
+        // queue this frame's draws, the lit pass goes through whichever shader the render mode needs
+        uint8_t sceneShaderId = renderMode == DEFERRED_RENDERING ? gBufferShaderId : diffuseLitShaderId;
+        renderQueue.begin(camera.Position, FAR_PLANE);
+        renderQueue.submit(RENDER_PASS_OPAQUE, sceneShaderId, containerMaterial, cubeVAO, cubeMesh, cubeInstances.First, cubeInstances.Count, visibleCubesCenter);
+        levelStreamer.submit(renderQueue, RENDER_PASS_OPAQUE, sceneShaderId, containerMaterial, frustum, &occlusionCuller);
+        renderQueue.submit(RENDER_PASS_UNLIT, lightingShaderId, NO_MATERIAL, lightCubeVAO, cubeMesh, lightCubeInstances.First, lightCubeInstances.Count, camera.Position);
+        renderQueue.sort();
+
+        // re-sort the point lights into the clusters of this frame's view
+        lightClusters.build(pointLights, frameConstants.get().view, projection, NEAR_PLANE, FAR_PLANE);
+        clusteredLightBuffers.uploadClusters(lightClusters);
+        clusteredLightBuffers.bind();
+        lightBlock.setClusterGrid(glm::uvec3(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z), (unsigned int) pointLights.size(), NEAR_PLANE, FAR_PLANE, framebufferWidth, framebufferHeight);
+
+        // spotLight follows the camera, only touch it while it's on so the light block stays clean
+        if (lightBlock.isSpotLightOn()) {
+            lightBlock.setSpotLightTransform(camera.Position, camera.Front);
+        }
+        lightBlock.upload();
 
-        // world transformation
-        glm::mat4 model = glm::mat4(1.0f);
-        diffuseLitShader.setMat4("model", model);
+        if (renderMode == DEFERRED_RENDERING) {
+            // geometry pass: material data only, no lighting
+            gBuffer.resize(framebufferWidth, framebufferHeight);
+            gBuffer.bindForWriting();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // bind diffuse map
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+            renderQueue.execute(RENDER_PASS_OPAQUE);
 
-        // bind specular map
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, specularMap);
+            // lighting pass: one fullscreen triangle, always filled even in wireframe mode
+            glState().bindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+            glState().disable(GL_DEPTH_TEST);
+            glState().setPolygonMode(GL_FILL);
 
-        glBindVertexArray(cubeVAO);
+            deferredLightingShader.use();
+            gBuffer.bindTextures();
+            glState().bindVertexArray(fullscreenVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
 
-        for (unsigned int i = 0; i < 10; i++) {
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, cubePositions[i]);
-            float angle = 20.0f * i;
-            model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            diffuseLitShader.setMat4("model", model);
+            setWireframeMode(wireframeModeOn);
+            glState().enable(GL_DEPTH_TEST);
 
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            // forward drawn objects below still need the scene depth
+            gBuffer.blitDepth(outputFramebuffer);
+        } else {
+            renderQueue.execute(RENDER_PASS_OPAQUE);
         }
 
-
         // also draw the lamp object(s)
-        lightingShader.use();
-        lightingShader.setMat4("projection", projection);
-        lightingShader.setMat4("view", view);
-
-        // we now draw as many light bulbs as we have point lights.
-        glBindVertexArray(lightCubeVAO);
-        for (unsigned int i = 0; i < 4; i++) { // NOLINT(*-loop-convert)
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, pointLightPositions[i]);
-            model = glm::scale(model, glm::vec3(0.2f)); // Make it a smaller cube
-            lightingShader.setMat4("model", model);
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+        renderQueue.execute(RENDER_PASS_UNLIT);
+        if (benchmark) gpuTimer.end();
+        frameRing.endFrame();
+
+        // swap buffers and handle I/O, headless frames are only flushed so the gpu starts on them right away
+        if (window) {
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        } else {
+            glFlush();
         }
 
-        // swap buffers and handle I/O
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // BENCHMARK
+        // ---------
+        if (warmingUp) {
+            warmupFrames++;
+        } else if (benchmark) {
+            std::chrono::duration<double, std::milli> cpuTime = std::chrono::steady_clock::now() - frameStart;
+            cpuFrameTimes.push_back(cpuTime.count());
+            gpuTimer.collect(gpuFrameTimes);
+            if (++timedFrames == options.frames) break;
+        }
+    }
+
+    if (benchmark) {
+        gpuTimer.collect(gpuFrameTimes, true);
+        const RenderQueueStats &queueStats = renderQueue.getStats();
+        std::cout << "Benchmark: " << timedFrames << " frames after " << warmupFrames << " warm up frames, " << framebufferWidth << "x"
+                  << framebufferHeight << " " << (renderMode == DEFERRED_RENDERING ? "deferred" : "forward") << ", last frame "
+                  << queueStats.draws << " draws in " << queueStats.drawCalls << " calls, " << levelStreamer.getStats().drawnChunks
+                  << " level chunks" << std::endl;
+        // a frame waits on the fence of the one Frames before it, so once the gpu is the bottleneck the cpu time shows it
+        // too. software rasterizers like llvmpipe leave most of their work out of the gpu time, trust the cpu one there
+        printFrameTimes("cpu", cpuFrameTimes);
+        printFrameTimes("gpu", gpuFrameTimes);
     }
 
 // optional: de-allocate all resources once they've outlived their purpose:
 // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteVertexArrays(1, &lightCubeVAO);
-    glDeleteBuffers(1, &VBO);
+    glState().deleteVertexArrays(1, &cubeVAO);
+    glState().deleteVertexArrays(1, &lightCubeVAO);
+    glState().deleteVertexArrays(1, &fullscreenVAO);
 
-    glfwTerminate();
     return 0;
 }
 
+void printFrameTimes(const char *name, const std::vector<double> &times) {
+    FrameTimeSummary summary = summarizeFrameTimes(times);
+    printf("%s frame ms over %zu frames: mean %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n", name, summary.frames, summary.mean,
+           summary.p50, summary.p95, summary.p99, summary.max);
+}
+
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {
     if (key == GLFW_KEY_GRAVE_ACCENT && action == GLFW_PRESS) {
         wireframeModeOn = !wireframeModeOn;
@@ -389,6 +689,16 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         setWireframeMode(wireframeModeOn);
     }
 
+    if (key == GLFW_KEY_F1 && action == GLFW_PRESS) {
+        renderMode = renderMode == DEFERRED_RENDERING ? FORWARD_RENDERING : DEFERRED_RENDERING;
+        std::cout << "Setting render mode: " << (renderMode == DEFERRED_RENDERING ? "deferred" : "forward") << std::endl;
+    }
+
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS) {
+        const GLStateStats &stats = glState().getStats();
+        std::cout << "GL state calls this frame: " << stats.issued << " issued, " << stats.elided << " elided" << std::endl;
+    }
+
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         std::cout << "\nExiting via escape key\n";
         glfwSetWindowShouldClose(window, GLFW_TRUE);
@@ -445,13 +755,15 @@ void processInput(GLFWwindow *window) {
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     // adjust viewport to match window width / height
     glViewport(0, 0, width, height);
+    framebufferWidth = width;
+    framebufferHeight = height;
 }
 
 void setWireframeMode(int wireframeOn) {
     if (wireframeOn) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        glState().setPolygonMode(GL_LINE);
     } else {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glState().setPolygonMode(GL_FILL);
     }
 }
 
@@ -480,39 +792,4 @@ void mouse_callback(GLFWwindow *window, double xposIn, double yposIn) {
 
 void scroll_callback(GLFWwindow *window, double xOffset, double yOffset) {
     camera.ProcessMouseScroll(static_cast<float>(yOffset));
-}
-
-// utility function for loading a 2D texture from file
-// ---------------------------------------------------
-unsigned int loadTexture(char const *path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    } else {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
-
-    return textureID;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_MAPPED_FILE_H
+#define KIRA_SOURCE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// read-only memory mapping of a whole file, pages are read in by the os on first touch
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    // maps the file, returns false (and stays closed) if it doesn't exist or can't be mapped
+    bool open(const std::string &path);
+    void close();
+
+    // asks the os to start reading every page now so later accesses don't fault, call from a worker thread
+    void prefetch() const;
+
+    const unsigned char *data() const {
+        return static_cast<const unsigned char *>(address);
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool isOpen() const {
+        return address != nullptr;
+    }
+
+private:
+    void *address = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+};
+
+#endif //KIRA_SOURCE_MAPPED_FILE_H
@@ -0,0 +1,462 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "mesh.h"
+#include "includes/GL_STATE_CACHE.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+// VERTEX WELDING
+// --------------
+namespace {
+    struct VertexHash {
+        size_t operator()(const Vertex &vertex) const {
+            // FNV-1a over the raw bytes, welding only merges bit-identical vertices
+            const auto *bytes = reinterpret_cast<const unsigned char *>(&vertex);
+            size_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(Vertex); i++) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+    };
+
+    struct VertexEqual {
+        bool operator()(const Vertex &a, const Vertex &b) const {
+            return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+        }
+    };
+}
+
+MeshData weldVertices(const float *interleaved, size_t vertexCount) {
+    MeshData mesh;
+    mesh.indices.reserve(vertexCount);
+
+    std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> unique;
+    unique.reserve(vertexCount);
+
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float *v = interleaved + i * 8;
+
+        Vertex vertex{};
+        vertex.position = glm::vec3(v[0], v[1], v[2]);
+        vertex.normal = glm::vec3(v[3], v[4], v[5]);
+        vertex.texCoords = glm::vec2(v[6], v[7]);
+
+        auto inserted = unique.emplace(vertex, (unsigned int) mesh.vertices.size());
+        if (inserted.second) mesh.vertices.push_back(vertex);
+        mesh.indices.push_back(inserted.first->second);
+    }
+
+    return mesh;
+}
+
+// VERTEX CACHE OPTIMIZATION
+// -------------------------
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+namespace {
+    const int FORSYTH_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRI_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, unsigned int remainingTriangles) {
+        // no triangles left means the vertex will never be used again
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // the vertices of the last triangle get a fixed score so the next triangle doesn't just reuse its edge
+                score = LAST_TRI_SCORE;
+            } else {
+                float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (float) (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        // boost vertices with few triangles left so lone triangles are finished off instead of left behind
+        score += VALENCE_BOOST_SCALE * std::pow((float) remainingTriangles, -VALENCE_BOOST_POWER);
+        return score;
+    }
+}
+
+void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // vertex -> triangle adjacency stored as one flat array
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int index: indices) remaining[index]++;
+    for (size_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = (unsigned int) t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) vertexScores[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+
+    std::vector<int> cache;
+    std::vector<int> newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    long long bestTriangle = -1;
+    size_t scanStart = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        // nothing in the cache touches a live triangle, fall back to scanning for the best remaining one
+        if (bestTriangle < 0) {
+            float bestScore = -1.0f;
+            while (scanStart < triangleCount && emitted[scanStart]) scanStart++;
+            for (size_t t = scanStart; t < triangleCount; t++) {
+                if (!emitted[t] && triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (long long) t;
+                }
+            }
+        }
+
+        auto triangle = (size_t) bestTriangle;
+        emitted[triangle] = true;
+
+        // emit the triangle and push its vertices to the front of the cache
+        newCache.clear();
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[triangle * 3 + k];
+            output.push_back(v);
+            remaining[v]--;
+            newCache.push_back((int) v);
+        }
+        for (int v: cache) {
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) newCache.push_back(v);
+        }
+
+        // rescore everything that was in the cache, entries past the cache size fall out
+        for (size_t i = 0; i < newCache.size(); i++) {
+            int v = newCache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? (int) i : -1;
+            vertexScores[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int v: newCache) {
+            for (unsigned int a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++) {
+                unsigned int t = adjacency[a];
+                if (emitted[t]) continue;
+
+                float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+                triangleScores[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > FORSYTH_CACHE_SIZE) newCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(newCache);
+    }
+
+    indices.swap(output);
+}
+
+void optimizeVertexFetch(MeshData &mesh) {
+    std::vector<unsigned int> remap(mesh.vertices.size(), ~0u);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (unsigned int &index: mesh.indices) {
+        if (remap[index] == ~0u) {
+            remap[index] = (unsigned int) vertices.size();
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    mesh.vertices.swap(vertices);
+}
+
+float computeACMR(const std::vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize) {
+    if (indices.size() < 3) return 0.0f;
+
+    // FIFO cache, a vertex is a hit if it was transformed within the last cacheSize misses
+    std::vector<long long> insertedAt(vertexCount, -1);
+    long long misses = 0;
+
+    for (unsigned int index: indices) {
+        if (insertedAt[index] < 0 || misses - insertedAt[index] >= cacheSize) {
+            insertedAt[index] = misses;
+            misses++;
+        }
+    }
+
+    return (float) misses / (float) (indices.size() / 3);
+}
+
+void optimizeMesh(MeshData &mesh, const char *name) {
+    float before = computeACMR(mesh.indices, mesh.vertices.size());
+
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    optimizeVertexFetch(mesh);
+
+    float after = computeACMR(mesh.indices, mesh.vertices.size());
+    std::cout << "MESH::" << name << ": " << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3 << " triangles, ACMR " << before << " -> " << after << std::endl;
+}
+
+// VERTEX PACKING
+// --------------
+namespace {
+    unsigned int positionSize(PositionEncoding encoding) {
+        // 3 x 16 bit is padded to 8 bytes so the next attribute stays 4 byte aligned
+        return encoding == PositionEncoding::FLOAT32 ? 12 : 8;
+    }
+
+    unsigned int normalSize(NormalEncoding encoding) {
+        return encoding == NormalEncoding::FLOAT32 ? 12 : 4;
+    }
+
+    unsigned int texCoordSize(TexCoordEncoding encoding) {
+        return encoding == TexCoordEncoding::FLOAT32 ? 8 : 4;
+    }
+
+    int16_t toSnorm16(float value) {
+        return (int16_t) std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    uint16_t toUnorm16(float value) {
+        return (uint16_t) std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    uint32_t toSnorm10(float value) {
+        return (uint32_t) std::lround(std::clamp(value, -1.0f, 1.0f) * 511.0f) & 0x3FFu;
+    }
+
+    float signNotZero(float value) {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // projects the unit sphere onto an octahedron and unfolds it into the [-1, 1] square
+    glm::vec2 octahedralEncode(const glm::vec3 &normal) {
+        glm::vec3 n = normal / (std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z));
+        if (n.z >= 0.0f) return glm::vec2(n.x, n.y);
+        return glm::vec2((1.0f - std::fabs(n.y)) * signNotZero(n.x), (1.0f - std::fabs(n.x)) * signNotZero(n.y));
+    }
+
+    // avoids a division by zero for flat meshes, any scale decodes a zero extent correctly
+    float safeExtent(float extent) {
+        return extent > 0.0f ? extent : 1.0f;
+    }
+}
+
+unsigned int vertexStride(const VertexFormat &format) {
+    return positionSize(format.position) + normalSize(format.normal) + texCoordSize(format.texCoords);
+}
+
+VertexDecode makeVertexDecode(const VertexFormat &format, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                              const glm::vec2 &texCoordMin, const glm::vec2 &texCoordMax) {
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    glm::vec3 halfExtent = (boundsMax - boundsMin) * 0.5f;
+
+    VertexDecode decode;
+    if (format.position == PositionEncoding::SNORM16) {
+        decode.positionScale = halfExtent;
+        decode.positionOffset = center;
+    } else if (format.position == PositionEncoding::HALF_FLOAT) {
+        decode.positionOffset = center;
+    }
+    if (format.texCoords == TexCoordEncoding::UNORM16) {
+        decode.texCoordScale = texCoordMax - texCoordMin;
+        decode.texCoordOffset = texCoordMin;
+    }
+    decode.octahedralNormals = format.normal == NormalEncoding::OCTAHEDRAL16;
+    return decode;
+}
+
+std::vector<unsigned char> packVertices(const std::vector<Vertex> &vertices, const VertexFormat &format, VertexDecode &decode) {
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    glm::vec2 texCoordMin(0.0f), texCoordMax(0.0f);
+    if (!vertices.empty()) {
+        boundsMin = boundsMax = vertices[0].position;
+        texCoordMin = texCoordMax = vertices[0].texCoords;
+    }
+    for (const Vertex &vertex: vertices) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+        texCoordMin = glm::min(texCoordMin, vertex.texCoords);
+        texCoordMax = glm::max(texCoordMax, vertex.texCoords);
+    }
+
+    decode = makeVertexDecode(format, boundsMin, boundsMax, texCoordMin, texCoordMax);
+    return packVerticesWithDecode(vertices, format, decode);
+}
+
+std::vector<unsigned char> packVerticesWithDecode(const std::vector<Vertex> &vertices, const VertexFormat &format, const VertexDecode &decode) {
+    const glm::vec3 &center = decode.positionOffset;
+    const glm::vec3 &halfExtent = decode.positionScale;
+    const glm::vec2 &texCoordMin = decode.texCoordOffset;
+    const glm::vec2 &texCoordExtent = decode.texCoordScale;
+
+    unsigned int stride = vertexStride(format);
+    std::vector<unsigned char> packed(vertices.size() * stride, 0);
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex &vertex = vertices[i];
+        unsigned char *out = &packed[i * stride];
+
+        // position
+        if (format.position == PositionEncoding::FLOAT32) {
+            std::memcpy(out, &vertex.position, 12);
+        } else if (format.position == PositionEncoding::HALF_FLOAT) {
+            glm::vec3 relative = vertex.position - center;
+            uint16_t halves[3] = {(uint16_t) glm::packHalf1x16(relative.x), (uint16_t) glm::packHalf1x16(relative.y), (uint16_t) glm::packHalf1x16(relative.z)};
+            std::memcpy(out, halves, sizeof(halves));
+        } else {
+            int16_t shorts[3];
+            for (int axis = 0; axis < 3; axis++) shorts[axis] = toSnorm16((vertex.position[axis] - center[axis]) / safeExtent(halfExtent[axis]));
+            std::memcpy(out, shorts, sizeof(shorts));
+        }
+        out += positionSize(format.position);
+
+        // normal
+        glm::vec3 normal = glm::normalize(vertex.normal);
+        if (format.normal == NormalEncoding::FLOAT32) {
+            std::memcpy(out, &normal, 12);
+        } else if (format.normal == NormalEncoding::OCTAHEDRAL16) {
+            glm::vec2 octahedral = octahedralEncode(normal);
+            int16_t shorts[2] = {toSnorm16(octahedral.x), toSnorm16(octahedral.y)};
+            std::memcpy(out, shorts, sizeof(shorts));
+        } else {
+            uint32_t packedNormal = toSnorm10(normal.x) | (toSnorm10(normal.y) << 10) | (toSnorm10(normal.z) << 20);
+            std::memcpy(out, &packedNormal, sizeof(packedNormal));
+        }
+        out += normalSize(format.normal);
+
+        // texture coords
+        if (format.texCoords == TexCoordEncoding::FLOAT32) {
+            std::memcpy(out, &vertex.texCoords, 8);
+        } else {
+            uint16_t shorts[2];
+            for (int axis = 0; axis < 2; axis++) shorts[axis] = toUnorm16((vertex.texCoords[axis] - texCoordMin[axis]) / safeExtent(texCoordExtent[axis]));
+            std::memcpy(out, shorts, sizeof(shorts));
+        }
+    }
+
+    return packed;
+}
+
+void setVertexAttributes(const VertexFormat &format) {
+    unsigned int stride = vertexStride(format);
+    size_t offset = 0;
+
+    // position attribute
+    if (format.position == PositionEncoding::FLOAT32) {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei) stride, (void *) offset);
+    } else if (format.position == PositionEncoding::HALF_FLOAT) {
+        glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, (GLsizei) stride, (void *) offset);
+    } else {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, (GLsizei) stride, (void *) offset);
+    }
+    glEnableVertexAttribArray(0);
+    offset += positionSize(format.position);
+
+    // normal attribute
+    if (format.normal == NormalEncoding::FLOAT32) {
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei) stride, (void *) offset);
+    } else if (format.normal == NormalEncoding::OCTAHEDRAL16) {
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, (GLsizei) stride, (void *) offset);
+    } else {
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, (GLsizei) stride, (void *) offset);
+    }
+    glEnableVertexAttribArray(1);
+    offset += normalSize(format.normal);
+
+    // texture attribute
+    if (format.texCoords == TexCoordEncoding::FLOAT32) {
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei) stride, (void *) offset);
+    } else {
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei) stride, (void *) offset);
+    }
+    glEnableVertexAttribArray(2);
+}
+
+// GPU MESH
+// --------
+Mesh::Mesh(const MeshData &data, const VertexFormat &format) : Format(format) {
+    VertexCount = (unsigned int) data.vertices.size();
+    IndexCount = (unsigned int) data.indices.size();
+    Stride = vertexStride(format);
+
+    std::vector<unsigned char> packed = packVertices(data.vertices, format, Decode);
+
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) packed.size(), packed.data(), GL_STATIC_DRAW);
+
+    // the element buffer binding is vertex array state, it is attached in createVertexArray
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) (data.indices.size() * sizeof(unsigned int)), data.indices.data(), GL_STATIC_DRAW);
+}
+
+Mesh::~Mesh() {
+    glState().deleteBuffers(1, &VBO);
+    glState().deleteBuffers(1, &EBO);
+}
+
+unsigned int Mesh::createVertexArray() const {
+    unsigned int vertexArray;
+    glGenVertexArrays(1, &vertexArray);
+    glState().bindVertexArray(vertexArray);
+
+    glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    setVertexAttributes(Format);
+
+    glState().bindVertexArray(0);
+    return vertexArray;
+}
+
+// DECODE UNIFORMS
+// ---------------
+VertexDecodeUniforms::VertexDecodeUniforms(const Shader &shader) {
+    positionScale = shader.getUniform("positionScale");
+    positionOffset = shader.getUniform("positionOffset");
+    texCoordScale = shader.getUniform("texCoordScale");
+    texCoordOffset = shader.getUniform("texCoordOffset");
+    octahedralNormals = shader.getUniform("octahedralNormals");
+}
+
+void VertexDecodeUniforms::apply(Shader &shader, const VertexDecode &decode) const {
+    shader.setVec3(positionScale, decode.positionScale);
+    shader.setVec3(positionOffset, decode.positionOffset);
+    shader.setVec2(texCoordScale, decode.texCoordScale);
+    shader.setVec2(texCoordOffset, decode.texCoordOffset);
+    shader.setBool(octahedralNormals, decode.octahedralNormals);
+}
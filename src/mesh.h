@@ -0,0 +1,127 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_MESH_H
+#define KIRA_SOURCE_MESH_H
+
+#include <glm/glm.hpp>
+
+#include "includes/SHADER.h"
+
+#include <cstddef>
+#include <vector>
+
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+};
+
+// how each attribute is stored in the vertex buffer, the default packs a vertex into 16 bytes
+enum class PositionEncoding {
+    FLOAT32,    // 12 bytes
+    HALF_FLOAT, // 8 bytes, relative to the mesh's bounding box center
+    SNORM16     // 8 bytes, normalized to the mesh's bounding box
+};
+
+enum class NormalEncoding {
+    FLOAT32,        // 12 bytes
+    OCTAHEDRAL16,   // 4 bytes, octahedral map in 2x snorm16
+    INT_2_10_10_10  // 4 bytes, xyz as snorm10
+};
+
+enum class TexCoordEncoding {
+    FLOAT32, // 8 bytes
+    UNORM16  // 4 bytes, normalized to the mesh's uv range
+};
+
+struct VertexFormat {
+    PositionEncoding position = PositionEncoding::SNORM16;
+    NormalEncoding normal = NormalEncoding::OCTAHEDRAL16;
+    TexCoordEncoding texCoords = TexCoordEncoding::UNORM16;
+};
+
+// scale and offset that turn quantized attributes back into mesh space, see shaders/common/vertex_decode.glsl
+struct VertexDecode {
+    glm::vec3 positionScale = glm::vec3(1.0f);
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    glm::vec2 texCoordScale = glm::vec2(1.0f);
+    glm::vec2 texCoordOffset = glm::vec2(0.0f);
+    bool octahedralNormals = false;
+};
+
+// cpu side indexed triangle list
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+};
+
+// builds an indexed mesh from a non-indexed position/normal/uv float array, identical vertices are merged into one
+MeshData weldVertices(const float *interleaved, size_t vertexCount);
+
+// reorders triangles so consecutive triangles reuse vertices still in the post-transform cache (Forsyth's algorithm)
+void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount);
+
+// reorders vertices by first use so vertex fetches walk the buffer front to back, unreferenced vertices are dropped
+void optimizeVertexFetch(MeshData &mesh);
+
+// average cache miss ratio, vertices transformed per triangle with a FIFO post-transform cache of the given size
+float computeACMR(const std::vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize = 16);
+
+// runs the cache and fetch optimizations and reports the ACMR before and after
+void optimizeMesh(MeshData &mesh, const char *name);
+
+// size in bytes of one vertex stored with the given format
+unsigned int vertexStride(const VertexFormat &format);
+
+// quantizes vertices into the interleaved layout described by format and returns how to decode them
+std::vector<unsigned char> packVertices(const std::vector<Vertex> &vertices, const VertexFormat &format, VertexDecode &decode);
+
+// decode that maps the given ranges onto the quantized values, meshes packed with the same one can share a draw
+VertexDecode makeVertexDecode(const VertexFormat &format, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                              const glm::vec2 &texCoordMin, const glm::vec2 &texCoordMax);
+
+// quantizes vertices against a decode made up front, normalized values outside its ranges are clamped
+std::vector<unsigned char> packVerticesWithDecode(const std::vector<Vertex> &vertices, const VertexFormat &format, const VertexDecode &decode);
+
+// points attributes 0-2 of the bound vertex array at the bound array buffer
+void setVertexAttributes(const VertexFormat &format);
+
+// gpu buffers of an indexed mesh, drawn with glDrawElements
+class Mesh {
+public:
+    unsigned int VBO = 0;
+    unsigned int EBO = 0;
+    unsigned int VertexCount = 0;
+    unsigned int IndexCount = 0;
+
+    VertexFormat Format;
+    VertexDecode Decode;
+    unsigned int Stride = 0;
+
+    explicit Mesh(const MeshData &data, const VertexFormat &format = VertexFormat());
+
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    ~Mesh();
+
+    // creates a vertex array that reads this mesh's buffers, several vertex arrays can share one mesh
+    unsigned int createVertexArray() const;
+};
+
+// handles of the decode uniforms, resolve once per shader and apply before drawing each mesh
+struct VertexDecodeUniforms {
+    UniformHandle positionScale;
+    UniformHandle positionOffset;
+    UniformHandle texCoordScale;
+    UniformHandle texCoordOffset;
+    UniformHandle octahedralNormals;
+
+    explicit VertexDecodeUniforms(const Shader &shader);
+
+    void apply(Shader &shader, const VertexDecode &decode) const;
+};
+
+#endif //KIRA_SOURCE_MESH_H
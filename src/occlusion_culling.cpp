@@ -0,0 +1,301 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "occlusion_culling.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KIRA_OCCLUSION_SSE
+#endif
+
+namespace {
+    const int TILE_PIXELS = OCCLUSION_TILE_WIDTH * OCCLUSION_TILE_HEIGHT;
+
+    // clip space intersection with the near plane z = -w
+    glm::vec4 nearIntersection(const glm::vec4 &inside, const glm::vec4 &outside) {
+        float insideDistance = inside.z + inside.w;
+        float outsideDistance = outside.z + outside.w;
+        return glm::mix(inside, outside, insideDistance / (insideDistance - outsideDistance));
+    }
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height) {
+    tilesX = std::max(1, (width + OCCLUSION_TILE_WIDTH - 1) / OCCLUSION_TILE_WIDTH);
+    tilesY = std::max(1, (height + OCCLUSION_TILE_HEIGHT - 1) / OCCLUSION_TILE_HEIGHT);
+    this->width = tilesX * OCCLUSION_TILE_WIDTH;
+    this->height = tilesY * OCCLUSION_TILE_HEIGHT;
+
+    depth.assign((size_t) this->width * this->height, 1.0f);
+    tileMaxDepth.assign((size_t) tilesX * tilesY, 1.0f);
+    tileBins.resize((size_t) tilesX * tilesY);
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4 &viewProjection) {
+    this->viewProjection = viewProjection;
+    occluders.clear();
+    stats = OcclusionStats();
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3 *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, const glm::mat4 &model) {
+    if (indexCount < 3) return;
+    occluders.push_back({vertices, vertexCount, indices, indexCount, model});
+}
+
+// SETUP
+// -----
+void OcclusionCuller::setupTriangles(const Occluder &occluder, std::vector<Triangle> &triangles, std::vector<glm::vec4> &clip) const {
+    glm::mat4 modelViewProjection = viewProjection * occluder.model;
+    clip.resize(occluder.vertexCount);
+    for (size_t i = 0; i < occluder.vertexCount; i++) {
+        clip[i] = modelViewProjection * glm::vec4(occluder.vertices[i], 1.0f);
+    }
+
+    for (size_t i = 0; i + 2 < occluder.indexCount; i += 3) {
+        const glm::vec4 *v[3] = {&clip[occluder.indices[i]], &clip[occluder.indices[i + 1]], &clip[occluder.indices[i + 2]]};
+
+        int insideMask = 0;
+        for (int k = 0; k < 3; k++) {
+            if (v[k]->z + v[k]->w >= 0.0f) insideMask |= 1 << k;
+        }
+
+        if (insideMask == 7) {
+            addTriangle(*v[0], *v[1], *v[2], triangles);
+            continue;
+        }
+        if (insideMask == 0) continue;
+
+        // clip against the near plane, keeping the winding. one vertex behind leaves a quad, two leave a triangle
+        glm::vec4 polygon[4];
+        int count = 0;
+        for (int k = 0; k < 3; k++) {
+            const glm::vec4 &current = *v[k];
+            const glm::vec4 &next = *v[(k + 1) % 3];
+            bool currentInside = insideMask & (1 << k);
+            bool nextInside = insideMask & (1 << ((k + 1) % 3));
+
+            if (currentInside) polygon[count++] = current;
+            if (currentInside != nextInside) polygon[count++] = currentInside ? nearIntersection(current, next) : nearIntersection(next, current);
+        }
+
+        for (int k = 1; k + 1 < count; k++) addTriangle(polygon[0], polygon[k], polygon[k + 1], triangles);
+    }
+}
+
+void OcclusionCuller::addTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2, std::vector<Triangle> &triangles) const {
+    if (v0.w <= 0.0f || v1.w <= 0.0f || v2.w <= 0.0f) return;
+
+    // to pixels, y up
+    glm::vec3 s[3];
+    const glm::vec4 *v[3] = {&v0, &v1, &v2};
+    for (int k = 0; k < 3; k++) {
+        float inverseW = 1.0f / v[k]->w;
+        s[k] = glm::vec3((v[k]->x * inverseW * 0.5f + 0.5f) * (float) width, (v[k]->y * inverseW * 0.5f + 0.5f) * (float) height, v[k]->z * inverseW * 0.5f + 0.5f);
+    }
+
+    // back facing and degenerate triangles are skipped, the front faces of a closed occluder already cover them
+    float area = (s[1].x - s[0].x) * (s[2].y - s[0].y) - (s[2].x - s[0].x) * (s[1].y - s[0].y);
+    if (area <= 0.0f) return;
+
+    Triangle triangle;
+    triangle.minX = std::max(0, (int) std::floor(std::min({s[0].x, s[1].x, s[2].x})));
+    triangle.minY = std::max(0, (int) std::floor(std::min({s[0].y, s[1].y, s[2].y})));
+    triangle.maxX = std::min(width - 1, (int) std::floor(std::max({s[0].x, s[1].x, s[2].x})));
+    triangle.maxY = std::min(height - 1, (int) std::floor(std::max({s[0].y, s[1].y, s[2].y})));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+    // edge k runs between the other two vertices and is positive on the triangle's side, it equals the area at vertex k
+    float inverseArea = 1.0f / area;
+    triangle.depthA = triangle.depthB = triangle.depthC = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        const glm::vec3 &a = s[(k + 1) % 3];
+        const glm::vec3 &b = s[(k + 2) % 3];
+        triangle.edgeA[k] = a.y - b.y;
+        triangle.edgeB[k] = b.x - a.x;
+        triangle.edgeC[k] = (b.y - a.y) * a.x - (b.x - a.x) * a.y;
+
+        // depth is linear in screen space, interpolate it with the normalized edge functions as barycentrics
+        triangle.depthA += triangle.edgeA[k] * inverseArea * s[k].z;
+        triangle.depthB += triangle.edgeB[k] * inverseArea * s[k].z;
+        triangle.depthC += triangle.edgeC[k] * inverseArea * s[k].z;
+    }
+
+    triangles.push_back(triangle);
+}
+
+// RASTERIZATION
+// -------------
+void OcclusionCuller::rasterize() {
+    stats.occluders = occluders.size();
+    occluderTriangles.resize(std::max(occluderTriangles.size(), occluders.size()));
+
+    // 1. transform and set up every occluder's triangles, one occluder per job
+    ThreadPool::global().parallelFor(occluders.size(), 1, [this](size_t begin, size_t end) {
+        std::vector<glm::vec4> clip;
+        for (size_t i = begin; i < end; i++) {
+            occluderTriangles[i].clear();
+            setupTriangles(occluders[i], occluderTriangles[i], clip);
+        }
+    });
+
+    // 2. bin the triangles into the tiles their bounds touch
+    for (std::vector<const Triangle *> &bin: tileBins) bin.clear();
+    for (size_t i = 0; i < occluders.size(); i++) {
+        for (const Triangle &triangle: occluderTriangles[i]) {
+            int firstX = triangle.minX / OCCLUSION_TILE_WIDTH;
+            int lastX = triangle.maxX / OCCLUSION_TILE_WIDTH;
+            int firstY = triangle.minY / OCCLUSION_TILE_HEIGHT;
+            int lastY = triangle.maxY / OCCLUSION_TILE_HEIGHT;
+            for (int ty = firstY; ty <= lastY; ty++) {
+                for (int tx = firstX; tx <= lastX; tx++) tileBins[ty * tilesX + tx].push_back(&triangle);
+            }
+        }
+        stats.trianglesRasterized += occluderTriangles[i].size();
+    }
+
+    // 3. tiles don't share pixels, so each one is rasterized by a single thread without locking
+    ThreadPool::global().parallelFor(tileBins.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; tile++) rasterizeTile((int) tile);
+    });
+}
+
+void OcclusionCuller::rasterizeTile(int tile) {
+    int tileX = (tile % tilesX) * OCCLUSION_TILE_WIDTH;
+    int tileY = (tile / tilesX) * OCCLUSION_TILE_HEIGHT;
+    float *tileDepth = &depth[(size_t) tile * TILE_PIXELS];
+
+    std::fill(tileDepth, tileDepth + TILE_PIXELS, 1.0f);
+
+    for (const Triangle *triangle: tileBins[tile]) {
+        // rows are walked four pixels at a time from a 4 aligned start, the edge functions reject the extra pixels
+        int firstX = std::max(triangle->minX, tileX) & ~3;
+        int lastX = std::min(triangle->maxX, tileX + OCCLUSION_TILE_WIDTH - 1);
+        int firstY = std::max(triangle->minY, tileY);
+        int lastY = std::min(triangle->maxY, tileY + OCCLUSION_TILE_HEIGHT - 1);
+
+        for (int y = firstY; y <= lastY; y++) {
+            float centerY = (float) y + 0.5f;
+            float *row = tileDepth + (y - tileY) * OCCLUSION_TILE_WIDTH;
+
+            float rowEdge0 = triangle->edgeB[0] * centerY + triangle->edgeC[0];
+            float rowEdge1 = triangle->edgeB[1] * centerY + triangle->edgeC[1];
+            float rowEdge2 = triangle->edgeB[2] * centerY + triangle->edgeC[2];
+            float rowDepth = triangle->depthB * centerY + triangle->depthC;
+
+#ifdef KIRA_OCCLUSION_SSE
+            const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            __m128 edgeA0 = _mm_set1_ps(triangle->edgeA[0]);
+            __m128 edgeA1 = _mm_set1_ps(triangle->edgeA[1]);
+            __m128 edgeA2 = _mm_set1_ps(triangle->edgeA[2]);
+            __m128 depthA = _mm_set1_ps(triangle->depthA);
+            __m128 zero = _mm_setzero_ps();
+
+            for (int x = firstX; x <= lastX; x += 4) {
+                __m128 centerX = _mm_add_ps(_mm_set1_ps((float) x), laneOffsets);
+                __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeA0, centerX), _mm_set1_ps(rowEdge0));
+                __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeA1, centerX), _mm_set1_ps(rowEdge1));
+                __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeA2, centerX), _mm_set1_ps(rowEdge2));
+
+                // inside where the smallest of the three is non negative
+                __m128 inside = _mm_cmpge_ps(_mm_min_ps(_mm_min_ps(edge0, edge1), edge2), zero);
+                if (_mm_movemask_ps(inside) == 0) continue;
+
+                __m128 pixelDepth = _mm_add_ps(_mm_mul_ps(depthA, centerX), _mm_set1_ps(rowDepth));
+                __m128 previous = _mm_loadu_ps(row + x - tileX);
+                __m128 nearest = _mm_min_ps(previous, pixelDepth);
+                _mm_storeu_ps(row + x - tileX, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+            }
+#else
+            for (int x = firstX; x <= lastX; x++) {
+                float centerX = (float) x + 0.5f;
+                if (triangle->edgeA[0] * centerX + rowEdge0 < 0.0f) continue;
+                if (triangle->edgeA[1] * centerX + rowEdge1 < 0.0f) continue;
+                if (triangle->edgeA[2] * centerX + rowEdge2 < 0.0f) continue;
+                row[x - tileX] = std::min(row[x - tileX], triangle->depthA * centerX + rowDepth);
+            }
+#endif
+        }
+    }
+
+    tileMaxDepth[tile] = *std::max_element(tileDepth, tileDepth + TILE_PIXELS);
+}
+
+float OcclusionCuller::getDepth(int x, int y) const {
+    int tile = (y / OCCLUSION_TILE_HEIGHT) * tilesX + x / OCCLUSION_TILE_WIDTH;
+    return depth[(size_t) tile * TILE_PIXELS + (y % OCCLUSION_TILE_HEIGHT) * OCCLUSION_TILE_WIDTH + x % OCCLUSION_TILE_WIDTH];
+}
+
+// QUERIES
+// -------
+bool OcclusionCuller::isOccluded(const Aabb &bounds) const {
+    glm::vec2 screenMin(INFINITY);
+    glm::vec2 screenMax(-INFINITY);
+    float nearestDepth = INFINITY;
+
+    // the box's nearest depth is at one of its corners, no point inside it can be in front of that
+    for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 position(corner & 1 ? bounds.max.x : bounds.min.x, corner & 2 ? bounds.max.y : bounds.min.y, corner & 4 ? bounds.max.z : bounds.min.z);
+        glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+        if (clip.z < -clip.w || clip.w <= 0.0f) return false;
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 screen((ndc.x * 0.5f + 0.5f) * (float) width, (ndc.y * 0.5f + 0.5f) * (float) height);
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+        nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    // every pixel the box's rectangle touches
+    int firstX = std::max(0, (int) std::floor(screenMin.x));
+    int firstY = std::max(0, (int) std::floor(screenMin.y));
+    int lastX = std::min(width - 1, (int) std::floor(screenMax.x));
+    int lastY = std::min(height - 1, (int) std::floor(screenMax.y));
+
+    // off screen, that's for the frustum culler to decide
+    if (firstX > lastX || firstY > lastY) return false;
+
+    for (int tileY = firstY / OCCLUSION_TILE_HEIGHT; tileY <= lastY / OCCLUSION_TILE_HEIGHT; tileY++) {
+        for (int tileX = firstX / OCCLUSION_TILE_WIDTH; tileX <= lastX / OCCLUSION_TILE_WIDTH; tileX++) {
+            int tile = tileY * tilesX + tileX;
+
+            // the whole tile is nearer than the box
+            if (tileMaxDepth[tile] < nearestDepth) continue;
+
+            const float *tileDepth = &depth[(size_t) tile * TILE_PIXELS];
+            int x0 = std::max(firstX - tileX * OCCLUSION_TILE_WIDTH, 0);
+            int x1 = std::min(lastX - tileX * OCCLUSION_TILE_WIDTH, OCCLUSION_TILE_WIDTH - 1);
+            int y0 = std::max(firstY - tileY * OCCLUSION_TILE_HEIGHT, 0);
+            int y1 = std::min(lastY - tileY * OCCLUSION_TILE_HEIGHT, OCCLUSION_TILE_HEIGHT - 1);
+
+            for (int y = y0; y <= y1; y++) {
+                const float *row = tileDepth + y * OCCLUSION_TILE_WIDTH;
+                for (int x = x0; x <= x1; x++) {
+                    if (row[x] >= nearestDepth) return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void OcclusionCuller::removeOccluded(const Aabb *bounds, std::vector<uint32_t> &indices) {
+    occludedFlags.assign(indices.size(), 0);
+
+    ThreadPool::global().parallelFor(indices.size(), 64, [this, bounds, &indices](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) occludedFlags[i] = isOccluded(bounds[indices[i]]);
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (!occludedFlags[i]) indices[kept++] = indices[i];
+    }
+
+    stats.tested += indices.size();
+    stats.occluded += indices.size() - kept;
+    indices.resize(kept);
+}
@@ -0,0 +1,109 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_OCCLUSION_CULLING_H
+#define KIRA_SOURCE_OCCLUSION_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include "aabb_tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// the depth buffer is split into tiles that are rasterized independently on the thread pool
+const int OCCLUSION_TILE_WIDTH = 32;
+const int OCCLUSION_TILE_HEIGHT = 16;
+
+struct OcclusionStats {
+    size_t occluders = 0;
+    size_t trianglesRasterized = 0; // after clipping and back face culling
+    size_t tested = 0;
+    size_t occluded = 0;
+};
+
+// software occlusion culling: a few big occluders are rasterized into a small depth buffer on the cpu, then object
+// bounds are tested against it. there's no gpu readback, so the result is ready the same frame it's needed.
+// depth is ndc z remapped to [0, 1] with 1 cleared as the far plane
+class OcclusionCuller {
+public:
+    // the size is rounded up to whole tiles
+    explicit OcclusionCuller(int width = 256, int height = 144);
+
+    // clears the occluders and sets the camera for this frame
+    void beginFrame(const glm::mat4 &viewProjection);
+
+    // queues an indexed triangle mesh with counter clockwise front faces. the data is only read by rasterize, so it
+    // has to stay alive until then
+    void addOccluder(const glm::vec3 *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+                     const glm::mat4 &model = glm::mat4(1.0f));
+
+    // transforms, bins and rasterizes every queued occluder on the thread pool
+    void rasterize();
+
+    // true only if the box is certainly hidden behind the occluders, boxes crossing the near plane never are. safe to
+    // call from several threads once rasterize returned
+    bool isOccluded(const Aabb &bounds) const;
+
+    // removes the indices of occluded boxes from indices, bounds is indexed by the values in indices
+    void removeOccluded(const Aabb *bounds, std::vector<uint32_t> &indices);
+
+    int getWidth() const {
+        return width;
+    }
+
+    int getHeight() const {
+        return height;
+    }
+
+    // depth of pixel (x, y), y going up like in ndc
+    float getDepth(int x, int y) const;
+
+    const OcclusionStats &getStats() const {
+        return stats;
+    }
+
+private:
+    // screen space triangle ready for rasterization: three edge functions and the depth plane, all as a * x + b * y + c
+    struct Triangle {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depthA;
+        float depthB;
+        float depthC;
+        int minX, minY, maxX, maxY; // inclusive pixel bounds
+    };
+
+    struct Occluder {
+        const glm::vec3 *vertices;
+        size_t vertexCount;
+        const unsigned int *indices;
+        size_t indexCount;
+        glm::mat4 model;
+    };
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+
+    // tile major, each tile's pixels are contiguous rows of OCCLUSION_TILE_WIDTH
+    std::vector<float> depth;
+    std::vector<float> tileMaxDepth;
+
+    std::vector<Occluder> occluders;
+    std::vector<std::vector<Triangle>> occluderTriangles;
+    std::vector<std::vector<const Triangle *>> tileBins;
+    std::vector<uint8_t> occludedFlags;
+    OcclusionStats stats;
+
+    void setupTriangles(const Occluder &occluder, std::vector<Triangle> &triangles, std::vector<glm::vec4> &clip) const;
+    void addTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2, std::vector<Triangle> &triangles) const;
+    void rasterizeTile(int tile);
+};
+
+#endif //KIRA_SOURCE_OCCLUSION_CULLING_H
@@ -0,0 +1,222 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "render_queue.h"
+#include "includes/GL_EXTENSIONS.h"
+#include "includes/GL_STATE_CACHE.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    const int PASS_SHIFT = 60;
+    const int SHADER_SHIFT = 52;
+    const int MATERIAL_SHIFT = 40;
+    const int DEPTH_SHIFT = 16;
+
+    const uint32_t MAX_SHADERS = 1u << 8;
+    const uint32_t MAX_MATERIALS = 1u << 12;
+    const uint32_t MAX_DEPTH = (1u << 24) - 1;
+}
+
+RenderQueue::RenderQueue(RingBuffer *indirectBuffer) : indirectBuffer(indirectBuffer) {
+    materials.emplace_back();
+}
+
+uint8_t RenderQueue::addShader(Shader &shader) {
+    if (shaders.size() >= MAX_SHADERS) {
+        std::cout << "ERROR::RENDER_QUEUE::TOO_MANY_SHADERS: only " << MAX_SHADERS << " fit in the sort key" << std::endl;
+        return 0;
+    }
+
+    shaders.push_back(std::unique_ptr<ShaderEntry>(new ShaderEntry{&shader, VertexDecodeUniforms(shader), shader.getUniform("lodFade")}));
+    return (uint8_t) (shaders.size() - 1);
+}
+
+uint16_t RenderQueue::addMaterial(const std::vector<TextureHandle> &textures) {
+    if (materials.size() >= MAX_MATERIALS) {
+        std::cout << "ERROR::RENDER_QUEUE::TOO_MANY_MATERIALS: only " << MAX_MATERIALS << " fit in the sort key" << std::endl;
+        return NO_MATERIAL;
+    }
+
+    materials.push_back(textures);
+    return (uint16_t) (materials.size() - 1);
+}
+
+void RenderQueue::begin(const glm::vec3 &cameraPosition, float farPlane) {
+    this->cameraPosition = cameraPosition;
+    this->farPlane = farPlane;
+    commands.clear();
+    items.clear();
+    stats = RenderQueueStats();
+}
+
+void RenderQueue::submit(RenderPass pass, uint8_t shader, uint16_t material, unsigned int vertexArray, const Mesh &mesh,
+                         unsigned int firstInstance, unsigned int instanceCount, const glm::vec3 &center, float lodFade) {
+    if (instanceCount == 0 || mesh.IndexCount == 0) return;
+
+    addKey(pass, shader, material, vertexArray, center);
+    commands.push_back({&mesh.Decode, vertexArray, mesh.IndexCount, 0, 0, firstInstance, instanceCount, lodFade, false});
+}
+
+void RenderQueue::submit(RenderPass pass, uint8_t shader, uint16_t material, const GeometryPool &pool, int32_t geometry,
+                         const glm::vec3 &center, float lodFade) {
+    const GeometryRange &range = pool.getRange(geometry);
+    if (range.indexCount == 0) return;
+
+    addKey(pass, shader, material, pool.getVertexArray(), center);
+    commands.push_back({&pool.getDecode(), pool.getVertexArray(), range.indexCount, range.firstIndex, range.baseVertex,
+                        range.baseInstance, 1, lodFade, true});
+}
+
+void RenderQueue::addKey(RenderPass pass, uint8_t shader, uint16_t material, unsigned int vertexArray, const glm::vec3 &center) {
+    float distance = glm::length(center - cameraPosition) / farPlane;
+    auto depth = (uint32_t) (std::min(std::max(distance, 0.0f), 1.0f) * (float) MAX_DEPTH);
+
+    uint64_t key = (uint64_t) pass << PASS_SHIFT |
+                   (uint64_t) shader << SHADER_SHIFT |
+                   (uint64_t) (material & (MAX_MATERIALS - 1)) << MATERIAL_SHIFT |
+                   (uint64_t) depth << DEPTH_SHIFT |
+                   (uint64_t) (vertexArray & 0xFFFFu);
+
+    items.push_back({key, (uint32_t) commands.size()});
+}
+
+// least significant digit radix sort, one byte per pass. the histograms of all eight bytes are counted in one sweep,
+// and bytes that are the same in every key (the pass and shader bytes usually are) are skipped
+void RenderQueue::sort() {
+    size_t count = items.size();
+    if (count < 2) return;
+
+    size_t histograms[8][256] = {};
+    for (const SortItem &item: items) {
+        for (int digit = 0; digit < 8; digit++) histograms[digit][(item.key >> (digit * 8)) & 0xFF]++;
+    }
+
+    scratch.resize(count);
+    SortItem *source = items.data();
+    SortItem *destination = scratch.data();
+
+    for (int digit = 0; digit < 8; digit++) {
+        int shift = digit * 8;
+        size_t *histogram = histograms[digit];
+        if (histogram[(source[0].key >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            size_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != items.data()) items.swap(scratch);
+}
+
+void RenderQueue::execute(RenderPass pass) {
+    // the queue doesn't know what was bound since the last execute, so the first draw sets everything
+    int currentShader = -1;
+    int currentMaterial = -1;
+    unsigned int currentVertexArray = 0;
+
+    auto first = std::lower_bound(items.begin(), items.end(), (uint64_t) pass << PASS_SHIFT, [](const SortItem &item, uint64_t key) {
+        return item.key < key;
+    });
+
+    auto last = first;
+    while (last != items.end() && (int) (last->key >> PASS_SHIFT) == pass) ++last;
+
+    for (auto it = first; it != last; ++it) {
+        const DrawCommand &command = commands[it->command];
+        int shader = (int) (it->key >> SHADER_SHIFT & (MAX_SHADERS - 1));
+        int material = (int) (it->key >> MATERIAL_SHIFT & (MAX_MATERIALS - 1));
+        ShaderEntry &entry = *shaders[shader];
+
+        if (shader != currentShader) {
+            entry.shader->use();
+            currentShader = shader;
+            stats.shaderChanges++;
+        }
+
+        if (material != currentMaterial) {
+            const std::vector<TextureHandle> &textures = materials[material];
+            for (size_t unit = 0; unit < textures.size(); unit++) {
+                glState().bindTexture((unsigned int) unit, GL_TEXTURE_2D, textures[unit]->id());
+            }
+            currentMaterial = material;
+            stats.materialChanges++;
+        }
+
+        if (command.vertexArray != currentVertexArray) {
+            glState().bindVertexArray(command.vertexArray);
+            currentVertexArray = command.vertexArray;
+            stats.vertexArrayChanges++;
+        }
+
+        // uniforms are shadowed by the shader, repeating the same values costs nothing
+        entry.decodeUniforms.apply(*entry.shader, *command.decode);
+        entry.shader->setFloat(entry.lodFade, command.lodFade);
+
+        // the pooled draws right behind this one that share all of its state go out together
+        if (canMultiDraw(command)) {
+            auto end = it + 1;
+            uint64_t stateMask = ~(((uint64_t) MAX_DEPTH) << DEPTH_SHIFT);
+            while (end != last && (end->key & stateMask) == (it->key & stateMask)) {
+                const DrawCommand &next = commands[end->command];
+                if (!canMultiDraw(next) || next.vertexArray != command.vertexArray || next.decode != command.decode) break;
+                ++end;
+            }
+
+            if (end - it > 1) {
+                multiDraw(it, (size_t) (end - it));
+                it = end - 1;
+                continue;
+            }
+        }
+
+        draw(command);
+    }
+}
+
+void RenderQueue::draw(const DrawCommand &command) {
+    glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, (GLsizei) command.indexCount, GL_UNSIGNED_INT,
+                                                  (void *) ((size_t) command.firstIndex * sizeof(unsigned int)),
+                                                  (GLsizei) command.instanceCount, command.baseVertex, command.firstInstance);
+    stats.draws++;
+    stats.drawCalls++;
+}
+
+// draws that differ in a uniform (a lod fade) can't share a multi draw
+bool RenderQueue::canMultiDraw(const DrawCommand &command) const {
+    return command.pooled && command.lodFade == 0.0f && indirectBuffer && GLExtensions::global().multiDrawIndirect;
+}
+
+void RenderQueue::multiDraw(std::vector<SortItem>::const_iterator first, size_t count) {
+    RingAllocation allocation = indirectBuffer->allocate(count * sizeof(DrawElementsIndirectCommand), 4);
+    if (!allocation.data) {
+        // the ring is full this frame, draw one by one rather than not at all
+        for (size_t i = 0; i < count; i++) draw(commands[first[i].command]);
+        return;
+    }
+
+    auto *indirect = (DrawElementsIndirectCommand *) allocation.data;
+    for (size_t i = 0; i < count; i++) {
+        const DrawCommand &command = commands[first[i].command];
+        indirect[i] = {command.indexCount, command.instanceCount, command.firstIndex, command.baseVertex, command.firstInstance};
+    }
+    indirectBuffer->flush();
+
+    glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->ID);
+    GLExtensions::global().MultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void *) allocation.offset, (GLsizei) count, 0);
+    stats.draws += count;
+    stats.drawCalls++;
+    stats.multiDraws++;
+}
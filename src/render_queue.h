@@ -0,0 +1,130 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_RENDER_QUEUE_H
+#define KIRA_SOURCE_RENDER_QUEUE_H
+
+#include <glm/glm.hpp>
+
+#include "geometry_pool.h"
+#include "mesh.h"
+#include "includes/RING_BUFFER.h"
+#include "includes/SHADER.h"
+#include "includes/TEXTURE.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// passes run in this order, each one is executed separately so other work can happen in between
+enum RenderPass {
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_UNLIT = 1
+};
+
+// material 0 binds no textures
+const uint16_t NO_MATERIAL = 0;
+
+// counted over every execute since begin
+struct RenderQueueStats {
+    size_t draws = 0;     // queued draws executed
+    size_t drawCalls = 0; // gl calls they took, a multi draw counts once
+    size_t multiDraws = 0;
+    size_t shaderChanges = 0;
+    size_t materialChanges = 0;
+    size_t vertexArrayChanges = 0;
+};
+
+// collects the frame's draws, sorts them by a packed 64 bit key and submits them with as few state changes as possible.
+// the key, most significant bits first:
+//
+//   pass (4) | shader (8) | material (12) | depth (24) | vertex array (16)
+//
+// so draws group by the expensive state first and opaque draws sharing it go front to back for early depth rejection.
+// depth sits above the vertex array because most meshes here (level chunks) have a vertex array of their own.
+//
+// runs of draws from the same geometry pool with the same shader and material are submitted as one
+// glMultiDrawElementsIndirect when the driver has it, the commands are written to the ring buffer. without it, or
+// without a ring buffer, every draw is its own call
+class RenderQueue {
+public:
+    explicit RenderQueue(RingBuffer *indirectBuffer = nullptr);
+
+    // shaders and materials are registered once, draws refer to them by the returned id
+    uint8_t addShader(Shader &shader);
+
+    // texture i is bound to texture unit i. handles are read at execute time, so textures still streaming in are fine
+    uint16_t addMaterial(const std::vector<TextureHandle> &textures);
+
+    // starts a new frame, depth is the distance from the camera over farPlane
+    void begin(const glm::vec3 &cameraPosition, float farPlane);
+
+    // queues one instanced draw of the mesh, center places it for the front to back order. firstInstance is the base
+    // instance, for instance data that lives somewhere in a ring buffer. the mesh must outlive the frame's execute
+    void submit(RenderPass pass, uint8_t shader, uint16_t material, unsigned int vertexArray, const Mesh &mesh,
+                unsigned int firstInstance, unsigned int instanceCount, const glm::vec3 &center, float lodFade = 0.0f);
+
+    // queues a draw of one mesh of a pool with the transform in its instance slot, the pool must outlive the execute
+    void submit(RenderPass pass, uint8_t shader, uint16_t material, const GeometryPool &pool, int32_t geometry,
+                const glm::vec3 &center, float lodFade = 0.0f);
+
+    // radix sorts the queued draws by key
+    void sort();
+
+    // draws every queued draw of a pass in key order, call after sort
+    void execute(RenderPass pass);
+
+    size_t size() const {
+        return commands.size();
+    }
+
+    const RenderQueueStats &getStats() const {
+        return stats;
+    }
+
+private:
+    struct ShaderEntry {
+        Shader *shader;
+        VertexDecodeUniforms decodeUniforms;
+        UniformHandle lodFade;
+    };
+
+    struct DrawCommand {
+        const VertexDecode *decode;
+        unsigned int vertexArray;
+        unsigned int indexCount;
+        unsigned int firstIndex;
+        int baseVertex;
+        unsigned int firstInstance;
+        unsigned int instanceCount;
+        float lodFade;
+        bool pooled;
+    };
+
+    struct SortItem {
+        uint64_t key;
+        uint32_t command;
+    };
+
+    std::vector<std::unique_ptr<ShaderEntry>> shaders;
+    std::vector<std::vector<TextureHandle>> materials;
+
+    std::vector<DrawCommand> commands;
+    std::vector<SortItem> items;
+    std::vector<SortItem> scratch;
+
+    RingBuffer *indirectBuffer;
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    float farPlane = 1.0f;
+    RenderQueueStats stats;
+
+    void addKey(RenderPass pass, uint8_t shader, uint16_t material, unsigned int vertexArray, const glm::vec3 &center);
+    void draw(const DrawCommand &command);
+    bool canMultiDraw(const DrawCommand &command) const;
+    void multiDraw(std::vector<SortItem>::const_iterator first, size_t count);
+};
+
+#endif //KIRA_SOURCE_RENDER_QUEUE_H
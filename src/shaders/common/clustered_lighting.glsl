@@ -0,0 +1,60 @@
+#ifndef CLUSTERED_LIGHTING_GLSL
+#define CLUSTERED_LIGHTING_GLSL
+
+#include "frame_constants.glsl"
+#include "lights.glsl"
+
+// point lights and the per-cluster light lists, filled by src/clustered_lighting.cpp
+// bindings = LIGHT_DATA_TEXTURE_UNIT, CLUSTER_RANGES_TEXTURE_UNIT, LIGHT_INDICES_TEXTURE_UNIT
+layout (binding = 4) uniform samplerBuffer lightData;
+layout (binding = 5) uniform usamplerBuffer clusterRanges;
+layout (binding = 6) uniform usamplerBuffer lightIndices;
+
+struct PointLight {
+    vec3 position;
+    float range;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+PointLight fetchPointLight(int index) {
+    vec4 positionRange = texelFetch(lightData, index * 4);
+    vec4 ambientConstant = texelFetch(lightData, index * 4 + 1);
+    vec4 diffuseLinear = texelFetch(lightData, index * 4 + 2);
+    vec4 specularQuadratic = texelFetch(lightData, index * 4 + 3);
+
+    PointLight light;
+    light.position = positionRange.xyz;
+    light.range = positionRange.w;
+    light.ambient = ambientConstant.rgb;
+    light.constant = ambientConstant.w;
+    light.diffuse = diffuseLinear.rgb;
+    light.linear = diffuseLinear.w;
+    light.specular = specularQuadratic.rgb;
+    light.quadratic = specularQuadratic.w;
+    return light;
+}
+
+// returns the (offset, count) of the lights in the cluster containing a world position drawn at fragCoord
+uvec2 clusterLightRange(vec3 worldPos, vec2 fragCoord) {
+    float depth = max(-(view * vec4(worldPos, 1.0)).z, clusterGrid.depthParams.x);
+
+    uvec3 cluster;
+    cluster.xy = min(uvec2(fragCoord / clusterGrid.tileSize.xy), clusterGrid.size.xy - 1u);
+    cluster.z = min(uint(max(log(depth) * clusterGrid.depthParams.z + clusterGrid.depthParams.w, 0.0)), clusterGrid.size.z - 1u);
+
+    uint index = cluster.x + cluster.y * clusterGrid.size.x + cluster.z * clusterGrid.size.x * clusterGrid.size.y;
+    return texelFetch(clusterRanges, int(index)).xy;
+}
+
+int clusterLightIndex(uvec2 range, uint i) {
+    return int(texelFetch(lightIndices, int(range.x + i)).r);
+}
+
+#endif
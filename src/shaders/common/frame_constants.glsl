@@ -0,0 +1,15 @@
+#ifndef FRAME_CONSTANTS_GLSL
+#define FRAME_CONSTANTS_GLSL
+
+// per-frame camera data, written once a frame by src/includes/FRAME_CONSTANTS.h
+// binding = FRAME_CONSTANTS_BINDING
+layout (std140, binding = 1) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 inverseViewProjection;
+    vec3 cameraPosition;
+    float time;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef LIGHTS_GLSL
+#define LIGHTS_GLSL
+
+// lights are read from the LightBlock uniform buffer, members are ordered so each float fills the std140 padding
+// after a vec3. keep in sync with src/includes/LIGHTS.h
+struct DirLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct SpotLight {
+    vec3 position;
+    float cutOff;
+    vec3 direction;
+    float outerCutOff;
+
+    vec3 ambient;
+    float constant;
+    vec3 diffuse;
+    float linear;
+    vec3 specular;
+    float quadratic;
+
+    bool lightOn;
+};
+
+// layout of the cluster grid the point lights were sorted into
+struct ClusterGrid {
+    uvec4 size;        // tiles in x, tiles in y, depth slices, light count
+    vec4 depthParams;  // near, far, slice scale, slice bias
+    vec4 tileSize;     // pixels per tile in x and y
+};
+
+// binding = LIGHT_BLOCK_BINDING
+layout (std140, binding = 0) uniform LightBlock {
+    DirLight dirLight;
+    SpotLight spotLight;
+    ClusterGrid clusterGrid;
+};
+
+#endif
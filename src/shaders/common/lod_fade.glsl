@@ -0,0 +1,19 @@
+#ifndef LOD_FADE_GLSL
+#define LOD_FADE_GLSL
+
+// dithered cross-fade between two detail levels of a mesh, see LodGroup in src/lod.h. both levels are drawn during a
+// fade and every pixel is kept by exactly one of them: 0 keeps everything, a positive value f keeps the fraction f of
+// the pattern for the level fading in and -f keeps the rest for the level fading out
+uniform float lodFade;
+
+const float BAYER_4X4[16] = float[](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+
+void applyLodFade(vec2 fragCoord) {
+    if (lodFade == 0.0) return;
+
+    ivec2 pixel = ivec2(fragCoord) & 3;
+    float threshold = (BAYER_4X4[pixel.y * 4 + pixel.x] + 0.5) / 16.0;
+    if (lodFade > 0.0 ? threshold >= lodFade : threshold < -lodFade) discard;
+}
+
+#endif
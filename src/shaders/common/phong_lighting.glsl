@@ -0,0 +1,101 @@
+#ifndef PHONG_LIGHTING_GLSL
+#define PHONG_LIGHTING_GLSL
+
+#include "frame_constants.glsl"
+#include "clustered_lighting.glsl"
+
+// material inputs of a shaded point, sampled from the material textures in the forward path or read back from
+// the g-buffer in the deferred path
+struct Surface {
+    vec3 albedo;
+    vec3 specular;
+    float shininess;
+};
+
+// calculates the color when using a directional light.
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 normal, vec3 viewDir)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+    // combine results
+    vec3 ambient = light.ambient * surface.albedo;
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    vec3 specular = light.specular * spec * surface.specular;
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a point light.
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // combine results
+    vec3 ambient = light.ambient * surface.albedo;
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    vec3 specular = light.specular * spec * surface.specular;
+    ambient *= attenuation;
+    diffuse *= attenuation;
+    specular *= attenuation;
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction));
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    // combine results
+    vec3 ambient = light.ambient * surface.albedo;
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    vec3 specular = light.specular * spec * surface.specular;
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+    return (ambient + diffuse + specular);
+}
+
+// == =====================================================
+// Our lighting is set up in 3 phases: directional, clustered point lights and an optional flashlight
+// For each phase, a calculate function is defined that calculates the corresponding color
+// per lamp. Here we take all the calculated colors and sum them up for this fragment's final color.
+// == =====================================================
+vec3 shadeSurface(Surface surface, vec3 fragPos, vec3 normal, vec2 fragCoord)
+{
+    vec3 viewDir = normalize(cameraPosition - fragPos);
+
+    // phase 1: directional lighting
+    vec3 result = CalcDirLight(dirLight, surface, normal, viewDir);
+    // phase 2: point lights, only the ones assigned to this fragment's cluster
+    uvec2 lightRange = clusterLightRange(fragPos, fragCoord);
+    for (uint i = 0u; i < lightRange.y; i++)
+    result += CalcPointLight(fetchPointLight(clusterLightIndex(lightRange, i)), surface, normal, fragPos, viewDir);
+    // phase 3: spot light
+    if (spotLight.lightOn)
+    result += CalcSpotLight(spotLight, surface, normal, fragPos, viewDir);
+
+    return result;
+}
+
+#endif
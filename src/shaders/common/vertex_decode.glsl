@@ -0,0 +1,31 @@
+#ifndef VERTEX_DECODE_GLSL
+#define VERTEX_DECODE_GLSL
+
+// dequantization of the packed vertex formats, set per mesh from VertexDecode in src/mesh.h
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+uniform vec2 texCoordScale;
+uniform vec2 texCoordOffset;
+uniform bool octahedralNormals;
+
+vec3 decodePosition(vec3 position) {
+    return position * positionScale + positionOffset;
+}
+
+vec2 decodeTexCoords(vec2 texCoords) {
+    return texCoords * texCoordScale + texCoordOffset;
+}
+
+// folds the [-1, 1] square back onto the octahedron, unpacked 10_10_10_2 and float normals pass through
+vec3 decodeNormal(vec4 normal) {
+    if (!octahedralNormals) return normal.xyz;
+
+    vec3 n = vec3(normal.xy, 1.0 - abs(normal.x) - abs(normal.y));
+    if (n.z < 0.0) {
+        vec2 signs = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signs;
+    }
+    return normalize(n);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#version 420 core
+#include "../common/phong_lighting.glsl"
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// bindings = GBUFFER_ALBEDO_SPEC_UNIT, GBUFFER_NORMAL_UNIT, GBUFFER_DEPTH_UNIT
+layout (binding = 0) uniform sampler2D gAlbedoSpec;
+layout (binding = 1) uniform sampler2D gNormalShininess;
+layout (binding = 2) uniform sampler2D gDepth;
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    // nothing was drawn here, keep the clear color
+    if (depth == 1.0)
+    discard;
+
+    // rebuild the world position from the depth buffer instead of storing it
+    vec4 clipPos = vec4(vec3(TexCoords, depth) * 2.0 - 1.0, 1.0);
+    vec4 worldPos = inverseViewProjection * clipPos;
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+
+    vec4 albedoSpec = texture(gAlbedoSpec, TexCoords);
+    vec4 normalShininess = texture(gNormalShininess, TexCoords);
+
+    Surface surface;
+    surface.albedo = albedoSpec.rgb;
+    surface.specular = vec3(albedoSpec.a);
+    surface.shininess = normalShininess.w;
+
+    FragColor = vec4(shadeSurface(surface, fragPos, normalize(normalShininess.xyz), gl_FragCoord.xy), 1.0);
+}
@@ -0,0 +1,30 @@
+#version 420 core
+#include "../common/lod_fade.glsl"
+
+// g-buffer targets, see src/includes/GBUFFER.h
+layout (location = 0) out vec4 gAlbedoSpec;      // rgb albedo, a specular intensity
+layout (location = 1) out vec4 gNormalShininess; // xyz world space normal, w shininess
+
+struct Material {
+    vec3 color;
+    sampler2D diffuse;
+    sampler2D specular;
+    float shininess;
+};
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform Material material;
+
+void main()
+{
+    applyLodFade(gl_FragCoord.xy);
+
+    // no lighting here, the lighting pass shades every visible pixel once
+    gAlbedoSpec.rgb = texture(material.diffuse, TexCoords).rgb;
+    // the specular maps are greyscale, one channel is enough
+    gAlbedoSpec.a = texture(material.specular, TexCoords).r;
+    gNormalShininess = vec4(normalize(Normal), material.shininess);
+}
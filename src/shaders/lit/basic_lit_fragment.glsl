@@ -1,7 +1,7 @@
-﻿#version 420 core
-
-out vec4 FragColor;
-
-void main() {
-    FragColor = vec4(1.0);
+#version 420 core
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = vec4(1.0);
 }
\ No newline at end of file
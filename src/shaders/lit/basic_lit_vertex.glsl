@@ -1,11 +1,13 @@
-﻿#version 420 core
-layout (location = 0) in vec3 aPos;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+#version 420 core
+#include "../common/frame_constants.glsl"
+#include "../common/vertex_decode.glsl"
+
+layout (location = 0) in vec3 aPos;
+
+// per-instance transform, see src/includes/INSTANCE_BUFFER.h
+layout (location = 3) in mat4 aModel;
+
+void main()
+{
+    gl_Position = viewProjection * aModel * vec4(decodePosition(aPos), 1.0);
 }
\ No newline at end of file
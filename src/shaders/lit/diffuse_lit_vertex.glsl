@@ -1,22 +1,25 @@
-﻿#version 420 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
-
-out vec3 Normal;
-out vec3 FragPos;
-out vec2 TexCoords;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-
-    // transposing and inversing is inneficient on a shader and should be done on the cpu and then sent to the shader instead
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    TexCoords = aTexCoords;
-
-    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
+#version 420 core
+#include "../common/frame_constants.glsl"
+#include "../common/vertex_decode.glsl"
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec4 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+// per-instance transforms, see src/includes/INSTANCE_BUFFER.h
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
+
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+
+void main() {
+    FragPos = vec3(aModel * vec4(decodePosition(aPos), 1.0));
+
+    // the normal matrix is computed on the cpu when the instance buffer is filled
+    Normal = aNormalMatrix * decodeNormal(aNormal);
+    TexCoords = decodeTexCoords(aTexCoords);
+
+    gl_Position = viewProjection * vec4(FragPos, 1.0);
+}
@@ -1,12 +1,12 @@
-﻿#version 420 core
-
-out vec4 FragColor;
-
-in vec2 TexCoord;
-
-uniform sampler2D containerTexture;
-
-void main()
-{
-    FragColor = texture(containerTexture, TexCoord);
+#version 420 core
+
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D containerTexture;
+
+void main()
+{
+    FragColor = texture(containerTexture, TexCoord);
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+
+size_t TextureCache::KeyHash::operator()(const Key &key) const {
+    size_t hash = std::hash<std::string>()(key.path);
+    const TextureParams &params = key.params;
+    for (size_t value: {(size_t) params.wrapS, (size_t) params.wrapT, (size_t) params.minFilter, (size_t) params.magFilter,
+                        (size_t) params.mipmaps, (size_t) params.srgb}) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+// "textures/../textures/a.png" and "textures/a.png" are the same file
+std::string TextureCache::canonicalPath(const std::string &path) {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    return error ? path : canonical.generic_string();
+}
+
+TextureHandle TextureCache::get(const std::string &path, const TextureParams &params) {
+    Key key{canonicalPath(path), params};
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        if (TextureHandle texture = it->second.lock()) {
+            hits++;
+            return texture;
+        }
+    }
+
+    misses++;
+    TextureHandle texture = loader.load(path, params);
+    entries[key] = texture;
+
+    // expired entries are only swept once the table has grown, lookups stay cheap in between
+    if (entries.size() >= purgeThreshold) {
+        purgeExpired();
+        purgeThreshold = std::max<size_t>(64, entries.size() * 2);
+    }
+
+    return texture;
+}
+
+void TextureCache::purgeExpired() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) it = entries.erase(it);
+        else ++it;
+    }
+}
+
+size_t TextureCache::liveCount() const {
+    size_t count = 0;
+    for (const auto &entry: entries) {
+        if (!entry.second.expired()) count++;
+    }
+    return count;
+}
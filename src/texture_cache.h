@@ -0,0 +1,64 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_TEXTURE_CACHE_H
+#define KIRA_SOURCE_TEXTURE_CACHE_H
+
+#include "texture_loader.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// hands out one shared texture per file and parameter set. the cache only keeps weak references, the GL texture is
+// freed as soon as the last handle to it is dropped and the next request for the file loads it again
+class TextureCache {
+public:
+    explicit TextureCache(TextureLoader &loader) : loader(loader) {}
+
+    TextureCache(const TextureCache &) = delete;
+    TextureCache &operator=(const TextureCache &) = delete;
+
+    // returns the live texture for path + params, or starts loading it
+    TextureHandle get(const std::string &path, const TextureParams &params = {});
+
+    // drops the entries of textures that have already been freed
+    void purgeExpired();
+
+    // number of textures currently alive
+    size_t liveCount() const;
+
+    size_t getHits() const {
+        return hits;
+    }
+
+    size_t getMisses() const {
+        return misses;
+    }
+
+private:
+    struct Key {
+        std::string path;
+        TextureParams params;
+
+        bool operator==(const Key &other) const {
+            return path == other.path && params == other.params;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    TextureLoader &loader;
+    std::unordered_map<Key, std::weak_ptr<Texture>, KeyHash> entries;
+    size_t purgeThreshold = 64;
+    size_t hits = 0;
+    size_t misses = 0;
+
+    static std::string canonicalPath(const std::string &path);
+};
+
+#endif //KIRA_SOURCE_TEXTURE_CACHE_H
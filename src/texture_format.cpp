@@ -0,0 +1,75 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "texture_format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+bool parseCookedTexture(const unsigned char *data, size_t size, CookedTexture &texture) {
+    if (size < sizeof(KtexHeader)) {
+        std::cout << "ERROR::KTEX::TRUNCATED_HEADER" << std::endl;
+        return false;
+    }
+
+    std::memcpy(&texture.header, data, sizeof(KtexHeader));
+    const KtexHeader &header = texture.header;
+
+    if (header.magic != KTEX_MAGIC || header.version != KTEX_VERSION) {
+        std::cout << "ERROR::KTEX::UNSUPPORTED_VERSION: " << header.version << std::endl;
+        return false;
+    }
+
+    if (header.width == 0 || header.height == 0 || header.width > INT32_MAX || header.height > INT32_MAX) {
+        std::cout << "ERROR::KTEX::INVALID_SIZE: " << header.width << "x" << header.height << std::endl;
+        return false;
+    }
+
+    // rows of 4x4 blocks of 8 bytes when compressed, rows of 4 byte pixels otherwise
+    bool compressed = (header.flags & KTEX_FLAG_COMPRESSED) != 0;
+    bool knownFormat = compressed ? header.internalFormat == KTEX_GL_COMPRESSED_RGBA_S3TC_DXT1 || header.internalFormat == KTEX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1
+                                  : header.internalFormat == KTEX_GL_RGBA8 && header.format == KTEX_GL_RGBA && header.type == KTEX_GL_UNSIGNED_BYTE;
+    if (!knownFormat) {
+        std::cout << "ERROR::KTEX::UNSUPPORTED_FORMAT: " << header.internalFormat << std::endl;
+        return false;
+    }
+    uint32_t rowHeight = compressed ? 4 : 1;
+    uint64_t unitBytes = compressed ? 8 : 4;
+
+    if (header.levelCount == 0 || header.levelCount > (uint32_t) mipLevelCount((int) header.width, (int) header.height) ||
+        size < sizeof(KtexHeader) + header.levelCount * sizeof(KtexLevel)) {
+        std::cout << "ERROR::KTEX::INVALID_LEVEL_TABLE" << std::endl;
+        return false;
+    }
+
+    texture.levels.resize(header.levelCount);
+    std::memcpy(texture.levels.data(), data + sizeof(KtexHeader), header.levelCount * sizeof(KtexLevel));
+
+    // every level has to be the next step of the mip chain, glTexStorage2D allocates exactly that and the loader's
+    // row arithmetic relies on the pitch covering a whole row
+    for (uint32_t i = 0; i < header.levelCount; i++) {
+        const KtexLevel &level = texture.levels[i];
+        uint32_t width = std::max(header.width >> i, 1u);
+        uint32_t height = std::max(header.height >> i, 1u);
+        uint64_t units = ((uint64_t) width + rowHeight - 1) / rowHeight;
+        uint64_t rows = ((uint64_t) height + rowHeight - 1) / rowHeight;
+        if (level.width != width || level.height != height || level.rowHeight != rowHeight || level.rowPitch < units * unitBytes) {
+            std::cout << "ERROR::KTEX::INVALID_LEVEL: " << i << std::endl;
+            return false;
+        }
+        if (level.offset > size || level.size > size - level.offset || level.size < rows * level.rowPitch) {
+            std::cout << "ERROR::KTEX::LEVEL_OUT_OF_RANGE" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int mipLevelCount(int width, int height) {
+    int levels = 1;
+    while ((width | height) >> levels) levels++;
+    return levels;
+}
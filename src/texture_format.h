@@ -0,0 +1,71 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_TEXTURE_FORMAT_H
+#define KIRA_SOURCE_TEXTURE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// COOKED TEXTURE (.ktex)
+// ----------------------
+// written offline by tools/texture_cooker, every mip level is stored in the exact layout glTexSubImage2D /
+// glCompressedTexSubImage2D expect so the loader maps the file and hands the bytes straight to GL.
+//
+//   KtexHeader
+//   KtexLevel[levelCount]
+//   level data, each level starting on a KTEX_DATA_ALIGNMENT boundary
+
+const uint32_t KTEX_MAGIC = 0x5845544B; // "KTEX"
+const uint32_t KTEX_VERSION = 1;
+const uint32_t KTEX_DATA_ALIGNMENT = 16;
+
+// gl enums of the formats the cooker writes, s3tc isn't core so glad doesn't define it
+const uint32_t KTEX_GL_RGBA8 = 0x8058;                        // GL_RGBA8
+const uint32_t KTEX_GL_RGBA = 0x1908;                         // GL_RGBA
+const uint32_t KTEX_GL_UNSIGNED_BYTE = 0x1401;                // GL_UNSIGNED_BYTE
+const uint32_t KTEX_GL_COMPRESSED_RGBA_S3TC_DXT1 = 0x83F1;    // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+const uint32_t KTEX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1 = 0x8C4D; // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+
+const uint32_t KTEX_FLAG_COMPRESSED = 1;
+
+struct KtexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t internalFormat; // sized gl internal format, or the compressed format
+    uint32_t format;         // pixel transfer format, 0 when compressed
+    uint32_t type;           // pixel transfer type, 0 when compressed
+    uint32_t flags;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t reserved;
+};
+
+struct KtexLevel {
+    uint64_t offset;    // from the start of the file
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowPitch;  // bytes per row of pixels, or per row of blocks when compressed
+    uint32_t rowHeight; // pixels per row, 4 for block compressed formats
+};
+
+static_assert(sizeof(KtexHeader) == 40, "KtexHeader must not contain padding");
+static_assert(sizeof(KtexLevel) == 32, "KtexLevel must not contain padding");
+
+// header and level table of a cooked texture, the level offsets point into the caller's buffer
+struct CookedTexture {
+    KtexHeader header;
+    std::vector<KtexLevel> levels;
+};
+
+// validates the header and every level range against the file size
+bool parseCookedTexture(const unsigned char *data, size_t size, CookedTexture &texture);
+
+// number of mip levels down to 1x1
+int mipLevelCount(int width, int height);
+
+#endif //KIRA_SOURCE_TEXTURE_FORMAT_H
@@ -0,0 +1,265 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "texture_loader.h"
+#include "texture_format.h"
+#include "job_system.h"
+#include "includes/GL_STATE_CACHE.h"
+#include "includes/GL_EXTENSIONS.h"
+
+#include "glad/glad.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace {
+    // maps a .ktex file, the levels are used in place
+    bool readCooked(const std::string &path, TextureSource &source, bool compressedSupported) {
+        auto file = std::make_unique<MappedFile>();
+        if (!file->open(path)) return false;
+
+        CookedTexture cooked;
+        if (!parseCookedTexture(file->data(), file->size(), cooked)) {
+            std::cout << "ERROR::TEXTURE_LOADER::INVALID_COOKED_TEXTURE: " << path << std::endl;
+            return false;
+        }
+
+        // glTexStorage2D would fail and leave the texture blank
+        if ((cooked.header.flags & KTEX_FLAG_COMPRESSED) && !compressedSupported) {
+            std::cout << "ERROR::TEXTURE_LOADER::COMPRESSED_FORMAT_UNSUPPORTED: " << path << " needs GL_EXT_texture_compression_s3tc" << std::endl;
+            return false;
+        }
+
+        // fault the pages in here rather than during the upload on the GL thread
+        file->prefetch();
+
+        source.internalFormat = cooked.header.internalFormat;
+        source.format = cooked.header.format;
+        source.type = cooked.header.type;
+        source.compressed = (cooked.header.flags & KTEX_FLAG_COMPRESSED) != 0;
+        for (const KtexLevel &level: cooked.levels) {
+            source.levels.push_back({(size_t) level.offset, (size_t) level.size, (int) level.width, (int) level.height, level.rowPitch, (int) level.rowHeight});
+        }
+        source.file = std::move(file);
+        return true;
+    }
+
+    // decodes an image with stb_image, the mip chain is generated by the driver after the upload
+    bool readImage(const std::string &path, TextureSource &source) {
+        int width, height, channels;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!data) return false;
+
+        source.pixels.assign(data, data + (size_t) width * height * 4);
+        stbi_image_free(data);
+
+        source.internalFormat = GL_RGBA8;
+        source.format = GL_RGBA;
+        source.type = GL_UNSIGNED_BYTE;
+        source.generateMipmaps = true;
+        source.levels.push_back({0, source.pixels.size(), width, height, (size_t) width * 4, 1});
+        return true;
+    }
+
+    // trims or converts the source to what the params ask for before any storage is allocated
+    void applyParams(TextureSource &source, const TextureParams &params) {
+        if (!params.mipmaps) {
+            source.generateMipmaps = false;
+            source.levels.resize(1);
+        }
+
+        if (params.srgb) {
+            if (source.internalFormat == GL_RGBA8) source.internalFormat = GL_SRGB8_ALPHA8;
+            else if (source.internalFormat == KTEX_GL_COMPRESSED_RGBA_S3TC_DXT1) source.internalFormat = KTEX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1;
+        }
+    }
+
+    // a texture without a mip chain can't use a mipmap filter, it would sample as incomplete
+    GLint baseLevelFilter(GLint filter) {
+        switch (filter) {
+            case GL_NEAREST_MIPMAP_NEAREST:
+            case GL_NEAREST_MIPMAP_LINEAR:
+                return GL_NEAREST;
+            case GL_LINEAR_MIPMAP_NEAREST:
+            case GL_LINEAR_MIPMAP_LINEAR:
+                return GL_LINEAR;
+            default:
+                return filter;
+        }
+    }
+}
+
+TextureSource readTextureSource(const std::string &path, bool compressedSupported) {
+    TextureSource source;
+    std::filesystem::path filePath(path);
+
+    if (filePath.extension() == ".ktex") {
+        readCooked(path, source, compressedSupported);
+        return source;
+    }
+
+    // prefer the cooked copy unless the source image was edited after it was cooked
+    std::filesystem::path cookedPath = filePath;
+    cookedPath.replace_extension(".ktex");
+
+    std::error_code error;
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+    if (!error) {
+        auto imageTime = std::filesystem::last_write_time(filePath, error);
+        if ((error || cookedTime >= imageTime) && readCooked(cookedPath.string(), source, compressedSupported)) return source;
+    }
+
+    source = TextureSource();
+    readImage(path, source);
+    return source;
+}
+
+TextureLoader::TextureLoader(size_t uploadBudget) : uploadBudget(std::max<size_t>(uploadBudget, 4)) {
+    glGenBuffers(1, &pixelBuffer);
+
+    // 1x1 mid grey, bound in place of every texture that hasn't finished loading
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    glGenTextures(1, &placeholder);
+    glState().bindTexture(GL_TEXTURE_2D, placeholder);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+TextureLoader::~TextureLoader() {
+    // decodes still running finish on their own, their results are dropped with the futures
+    glState().deleteBuffers(1, &pixelBuffer);
+    glState().deleteTextures(1, &placeholder);
+}
+
+TextureHandle TextureLoader::load(const std::string &path, const TextureParams &params) {
+    TextureHandle texture = std::make_shared<Texture>(placeholder);
+
+    // the worker can't ask the driver, it is told whether block compressed formats can be uploaded
+    const GLExtensions &extensions = GLExtensions::global();
+    bool compressedSupported = params.srgb ? extensions.textureCompressionS3tcSrgb : extensions.textureCompressionS3tc;
+    std::future<TextureSource> source = ThreadPool::global().submit([path, compressedSupported]() {
+        return readTextureSource(path, compressedSupported);
+    });
+
+    pending.push_back({texture, params, path, std::move(source)});
+    return texture;
+}
+
+void TextureLoader::update() {
+    // collect finished decodes in request order, a slow file doesn't hold back the ones behind it
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->source.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        TextureSource source = it->source.get();
+        if (it->texture.use_count() == 1) {
+            // every handle was dropped while the file was decoding, nobody will ever see this texture
+        } else if (source.empty()) {
+            std::cout << "Texture failed to load at path: " << it->path << std::endl;
+            it->texture->setState(TEXTURE_FAILED);
+        } else {
+            applyParams(source, it->params);
+            uploads.push_back({it->texture, it->params, std::move(source)});
+            beginUpload(uploads.back());
+        }
+        it = pending.erase(it);
+    }
+
+    // stream rows until this frame's budget is spent
+    size_t budget = uploadBudget;
+    while (!uploads.empty() && budget > 0) {
+        PendingUpload &upload = uploads.front();
+
+        // abandoned uploads are dropped instead of spending the budget on them
+        if (upload.texture.use_count() == 1) {
+            uploads.pop_front();
+            continue;
+        }
+
+        budget -= uploadRows(upload, budget);
+
+        if (upload.level < upload.source.levels.size()) continue;
+
+        finishUpload(upload);
+        uploads.pop_front();
+    }
+}
+
+void TextureLoader::beginUpload(PendingUpload &upload) {
+    Texture &texture = *upload.texture;
+    const TextureSource &source = upload.source;
+    texture.Width = source.levels[0].width;
+    texture.Height = source.levels[0].height;
+    texture.Levels = source.generateMipmaps ? mipLevelCount(texture.Width, texture.Height) : (int) source.levels.size();
+
+    // immutable storage for the whole chain up front, the rows are filled in over the next frames
+    glState().bindTexture(GL_TEXTURE_2D, texture.ID);
+    glTexStorage2D(GL_TEXTURE_2D, texture.Levels, source.internalFormat, texture.Width, texture.Height);
+}
+
+size_t TextureLoader::uploadRows(PendingUpload &upload, size_t budget) {
+    const TextureSource &source = upload.source;
+    const TextureSourceLevel &level = source.levels[upload.level];
+    int rowCount = (level.height + level.rowHeight - 1) / level.rowHeight;
+
+    // always make progress, even when a single row is bigger than the budget
+    int rows = (int) std::max<size_t>(budget / level.rowPitch, 1);
+    rows = std::min(rows, rowCount - upload.nextRow);
+    size_t size = level.rowPitch * rows;
+
+    int y = upload.nextRow * level.rowHeight;
+    int height = std::min(rows * level.rowHeight, level.height - y);
+
+    // orphan the pixel buffer so we never wait on the previous slice still being read by the driver
+    glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_DRAW);
+    void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        std::memcpy(mapped, source.bytes() + level.offset + level.rowPitch * upload.nextRow, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glState().bindTexture(GL_TEXTURE_2D, upload.texture->ID);
+        if (source.compressed) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, (GLint) upload.level, 0, y, level.width, height, source.internalFormat, (GLsizei) size, nullptr);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, (GLint) upload.level, 0, y, level.width, height, source.format, source.type, nullptr);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    } else {
+        std::cout << "ERROR::TEXTURE_LOADER::PIXEL_BUFFER_MAP_FAILED" << std::endl;
+    }
+    glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    upload.nextRow += rows;
+    if (upload.nextRow >= rowCount) {
+        upload.level++;
+        upload.nextRow = 0;
+    }
+
+    return std::min(size, budget);
+}
+
+void TextureLoader::finishUpload(PendingUpload &upload) {
+    Texture &texture = *upload.texture;
+
+    glState().bindTexture(GL_TEXTURE_2D, texture.ID);
+    if (upload.source.generateMipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+
+    const TextureParams &params = upload.params;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.Levels > 1 ? params.minFilter : baseLevelFilter(params.minFilter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+
+    texture.setState(TEXTURE_READY);
+}
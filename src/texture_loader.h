@@ -0,0 +1,110 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_TEXTURE_LOADER_H
+#define KIRA_SOURCE_TEXTURE_LOADER_H
+
+#include "includes/TEXTURE.h"
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// one mip level of a texture source, offset is relative to TextureSource::bytes()
+struct TextureSourceLevel {
+    size_t offset = 0;
+    size_t size = 0;
+    int width = 0;
+    int height = 0;
+    size_t rowPitch = 0; // bytes per row, a row is rowHeight pixels tall (4 for block compressed data)
+    int rowHeight = 1;
+};
+
+// texels ready for upload, produced on a worker thread. decoded images own their pixels, cooked textures point
+// straight into the mapped file
+struct TextureSource {
+    std::vector<TextureSourceLevel> levels;
+    unsigned int internalFormat = 0;
+    unsigned int format = 0;
+    unsigned int type = 0;
+    bool compressed = false;
+    bool generateMipmaps = false;
+
+    std::vector<unsigned char> pixels;
+    std::unique_ptr<MappedFile> file;
+
+    const unsigned char *bytes() const {
+        return file ? file->data() : pixels.data();
+    }
+
+    bool empty() const {
+        return levels.empty();
+    }
+};
+
+// loads textures without blocking the main thread: files are decoded on the thread pool and the texels are
+// streamed into GL through a pixel buffer object a few rows at a time, bounded by a per-frame byte budget.
+// a cooked .ktex next to the requested image (see tools/texture_cooker) is used instead when it's up to date
+class TextureLoader {
+public:
+    explicit TextureLoader(size_t uploadBudget = 1024 * 1024);
+
+    TextureLoader(const TextureLoader &) = delete;
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    ~TextureLoader();
+
+    // starts loading a texture, the handle binds the placeholder until ready() is true. every call creates a new
+    // texture, go through TextureCache to share them
+    TextureHandle load(const std::string &path, const TextureParams &params = {});
+
+    // call once per frame on the GL thread, finishes decodes and uploads up to the byte budget
+    void update();
+
+    // true when no texture is waiting to be decoded or uploaded
+    bool idle() const {
+        return pending.empty() && uploads.empty();
+    }
+
+    unsigned int getPlaceholder() const {
+        return placeholder;
+    }
+
+private:
+    struct PendingDecode {
+        TextureHandle texture;
+        TextureParams params;
+        std::string path;
+        std::future<TextureSource> source;
+    };
+
+    struct PendingUpload {
+        TextureHandle texture;
+        TextureParams params;
+        TextureSource source;
+        size_t level = 0;
+        int nextRow = 0;
+    };
+
+    std::deque<PendingDecode> pending;
+    std::deque<PendingUpload> uploads;
+
+    size_t uploadBudget;
+    unsigned int pixelBuffer = 0;
+    unsigned int placeholder = 0;
+
+    void beginUpload(PendingUpload &upload);
+    size_t uploadRows(PendingUpload &upload, size_t budget);
+    void finishUpload(PendingUpload &upload);
+};
+
+// worker side of the loader, reads a cooked texture or decodes an image. returns an empty source on failure.
+// without compressedSupported block compressed cooked textures are skipped in favour of the image they came from
+TextureSource readTextureSource(const std::string &path, bool compressedSupported = true);
+
+#endif //KIRA_SOURCE_TEXTURE_LOADER_H
@@ -0,0 +1,51 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+// offline level cooker, turns a comma separated level into the chunked .kgrid LevelStreamer maps
+//
+//   level_cooker [--chunk N] level.txt [level.kgrid]
+
+#include "../level_grid_file.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+    int chunkSize = 32;
+    std::string inputPath;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--chunk" && i + 1 < argc) chunkSize = std::stoi(argv[++i]);
+        else if (inputPath.empty()) inputPath = argument;
+        else outputPath = argument;
+    }
+
+    if (chunkSize > KGRID_MAX_CHUNK_SIZE) {
+        std::cout << "ERROR::LEVEL_COOKER::CHUNK_TOO_LARGE: chunks can be at most " << KGRID_MAX_CHUNK_SIZE << " cells" << std::endl;
+        return 1;
+    }
+    if (inputPath.empty() || chunkSize <= 0) {
+        std::cout << "usage: level_cooker [--chunk N] level.txt [level.kgrid]" << std::endl;
+        return 1;
+    }
+
+    if (outputPath.empty()) {
+        outputPath = inputPath.substr(0, inputPath.find_last_of('.')) + ".kgrid";
+    }
+
+    LevelParseResult result = cookLevelGrid(inputPath, outputPath, chunkSize);
+    if (!result.fileRead) {
+        std::cout << "ERROR::LEVEL_COOKER::READ_FAILED: " << inputPath << std::endl;
+        return 1;
+    }
+
+    for (const LevelParseIssue &issue: result.issues) {
+        std::cout << "warning: " << inputPath << ":" << issue.line << " " << issue.message << std::endl;
+    }
+
+    std::cout << "cooked " << inputPath << " -> " << outputPath << ": " << result.columns << "x" << result.rows << " cells, " << chunkSize << " cell chunks" << std::endl;
+    return 0;
+}
@@ -0,0 +1,242 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+// offline texture cooker, turns a png/jpeg into a .ktex with the full mip chain in upload layout
+//
+//   texture_cooker [--bc1] [--no-mips] input.png [output.ktex]
+//
+// the output defaults to the input path with a .ktex extension, which is where TextureLoader looks for it
+
+#include "../texture_format.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Image {
+    std::vector<unsigned char> pixels; // rgba8
+    int width = 0;
+    int height = 0;
+};
+
+// 2x2 box filter, odd edges reuse the last row / column
+static Image downsample(const Image &source) {
+    Image result;
+    result.width = std::max(source.width / 2, 1);
+    result.height = std::max(source.height / 2, 1);
+    result.pixels.resize((size_t) result.width * result.height * 4);
+
+    for (int y = 0; y < result.height; y++) {
+        int y0 = std::min(y * 2, source.height - 1);
+        int y1 = std::min(y * 2 + 1, source.height - 1);
+        for (int x = 0; x < result.width; x++) {
+            int x0 = std::min(x * 2, source.width - 1);
+            int x1 = std::min(x * 2 + 1, source.width - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = source.pixels[((size_t) y0 * source.width + x0) * 4 + c] +
+                          source.pixels[((size_t) y0 * source.width + x1) * 4 + c] +
+                          source.pixels[((size_t) y1 * source.width + x0) * 4 + c] +
+                          source.pixels[((size_t) y1 * source.width + x1) * 4 + c];
+                result.pixels[((size_t) y * result.width + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+// BC1 COMPRESSION
+// ---------------
+static uint16_t toRgb565(const int color[3]) {
+    return (uint16_t) (((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | ((color[2] * 31 + 127) / 255));
+}
+
+static void fromRgb565(uint16_t packed, int color[3]) {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// endpoints from the block's colour bounding box, inset slightly, then each texel picks the closest palette entry
+static void compressBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    int minColor[3] = {255, 255, 255};
+    int maxColor[3] = {0, 0, 0};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            minColor[c] = std::min(minColor[c], (int) block[i][c]);
+            maxColor[c] = std::max(maxColor[c], (int) block[i][c]);
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        int inset = (maxColor[c] - minColor[c]) / 16;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+
+    uint16_t color0 = toRgb565(maxColor);
+    uint16_t color1 = toRgb565(minColor);
+    // color0 > color1 selects the four colour mode, a flat block just uses index 0 everywhere
+    if (color0 < color1) std::swap(color0, color1);
+
+    int palette[4][3];
+    fromRgb565(color0, palette[0]);
+    fromRgb565(color1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDistance = 1 << 30;
+            for (int p = 0; p < 4; p++) {
+                int distance = 0;
+                for (int c = 0; c < 3; c++) {
+                    int d = block[i][c] - palette[p][c];
+                    distance += d * d;
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t) best << (i * 2);
+        }
+    }
+
+    out[0] = color0 & 0xFF;
+    out[1] = color0 >> 8;
+    out[2] = color1 & 0xFF;
+    out[3] = color1 >> 8;
+    for (int i = 0; i < 4; i++) out[4 + i] = (unsigned char) (indices >> (i * 8));
+}
+
+static std::vector<unsigned char> compressBC1(const Image &image) {
+    int blocksX = (image.width + 3) / 4;
+    int blocksY = (image.height + 3) / 4;
+    std::vector<unsigned char> result((size_t) blocksX * blocksY * 8);
+
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            // partial edge blocks repeat the last texel
+            unsigned char block[16][4];
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    int sx = std::min(bx * 4 + x, image.width - 1);
+                    int sy = std::min(by * 4 + y, image.height - 1);
+                    std::memcpy(block[y * 4 + x], &image.pixels[((size_t) sy * image.width + sx) * 4], 4);
+                }
+            }
+            compressBlock(block, &result[((size_t) by * blocksX + bx) * 8]);
+        }
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv) {
+    bool compress = false;
+    bool mips = true;
+    std::string inputPath;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--bc1") compress = true;
+        else if (argument == "--no-mips") mips = false;
+        else if (inputPath.empty()) inputPath = argument;
+        else outputPath = argument;
+    }
+
+    if (inputPath.empty()) {
+        std::cout << "usage: texture_cooker [--bc1] [--no-mips] input.png [output.ktex]" << std::endl;
+        return 1;
+    }
+
+    if (outputPath.empty()) {
+        outputPath = inputPath.substr(0, inputPath.find_last_of('.')) + ".ktex";
+    }
+
+    Image image;
+    int channels;
+    unsigned char *data = stbi_load(inputPath.c_str(), &image.width, &image.height, &channels, 4);
+    if (!data) {
+        std::cout << "ERROR::TEXTURE_COOKER::LOAD_FAILED: " << inputPath << " " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+    image.pixels.assign(data, data + (size_t) image.width * image.height * 4);
+    stbi_image_free(data);
+
+    if (compress && channels == 4) {
+        std::cout << "warning: bc1 drops the alpha channel of " << inputPath << std::endl;
+    }
+
+    // build every level in its final layout
+    std::vector<std::vector<unsigned char>> levelData;
+    std::vector<KtexLevel> levels;
+    int levelCount = mips ? mipLevelCount(image.width, image.height) : 1;
+
+    Image level = image;
+    for (int i = 0; i < levelCount; i++) {
+        if (i > 0) level = downsample(level);
+
+        KtexLevel entry{};
+        entry.width = (uint32_t) level.width;
+        entry.height = (uint32_t) level.height;
+        if (compress) {
+            levelData.push_back(compressBC1(level));
+            entry.rowPitch = (uint32_t) ((level.width + 3) / 4 * 8);
+            entry.rowHeight = 4;
+        } else {
+            levelData.push_back(level.pixels);
+            entry.rowPitch = (uint32_t) level.width * 4;
+            entry.rowHeight = 1;
+        }
+        entry.size = levelData.back().size();
+        levels.push_back(entry);
+    }
+
+    KtexHeader header{};
+    header.magic = KTEX_MAGIC;
+    header.version = KTEX_VERSION;
+    header.internalFormat = compress ? KTEX_GL_COMPRESSED_RGBA_S3TC_DXT1 : KTEX_GL_RGBA8;
+    header.format = compress ? 0 : KTEX_GL_RGBA;
+    header.type = compress ? 0 : KTEX_GL_UNSIGNED_BYTE;
+    header.flags = compress ? KTEX_FLAG_COMPRESSED : 0;
+    header.width = (uint32_t) image.width;
+    header.height = (uint32_t) image.height;
+    header.levelCount = (uint32_t) levelCount;
+
+    // lay the levels out after the table, each on an aligned offset
+    uint64_t offset = sizeof(KtexHeader) + levels.size() * sizeof(KtexLevel);
+    for (KtexLevel &entry: levels) {
+        offset = (offset + KTEX_DATA_ALIGNMENT - 1) / KTEX_DATA_ALIGNMENT * KTEX_DATA_ALIGNMENT;
+        entry.offset = offset;
+        offset += entry.size;
+    }
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "ERROR::TEXTURE_COOKER::WRITE_FAILED: " << outputPath << std::endl;
+        return 1;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(levels.data()), (std::streamsize) (levels.size() * sizeof(KtexLevel)));
+    for (size_t i = 0; i < levels.size(); i++) {
+        while ((uint64_t) file.tellp() < levels[i].offset) file.put(0);
+        file.write(reinterpret_cast<const char *>(levelData[i].data()), (std::streamsize) levelData[i].size());
+    }
+
+    std::cout << "cooked " << inputPath << " -> " << outputPath << ": " << image.width << "x" << image.height << ", " << levelCount << " levels, " << (compress ? "bc1" : "rgba8") << ", " << offset << " bytes" << std::endl;
+    return file ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#include "transform.h"
+#include "includes/INSTANCE_BUFFER.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KIRA_TRANSFORM_SSE
+#endif
+
+// relative tolerance when checking for orthogonal columns of equal length
+const float RIGID_EPSILON = 1e-4f;
+
+static bool isUniformScaleRigid(float length0, float length1, float length2, float dot01, float dot02, float dot12) {
+    float tolerance = RIGID_EPSILON * length0;
+    return length0 > 0.0f &&
+           std::fabs(length1 - length0) <= tolerance && std::fabs(length2 - length0) <= tolerance &&
+           std::fabs(dot01) <= tolerance && std::fabs(dot02) <= tolerance && std::fabs(dot12) <= tolerance;
+}
+
+#ifdef KIRA_TRANSFORM_SSE
+
+static inline __m128 cross3(__m128 a, __m128 b) {
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static inline float dot3(__m128 a, __m128 b) {
+    // w is always zero so a full horizontal add is a dot3
+    __m128 product = _mm_mul_ps(a, b);
+    __m128 shuffled = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(product, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+
+static inline void storeColumn(float *destination, __m128 column) {
+    float values[4];
+    _mm_storeu_ps(values, column);
+    std::memcpy(destination, values, 3 * sizeof(float));
+}
+
+void computeNormalMatrices(InstanceData *instances, size_t count) {
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+    for (size_t i = 0; i < count; i++) {
+        const glm::mat4 &model = instances[i].model;
+        float *normal = &instances[i].normalMatrix[0][0];
+
+        __m128 c0 = _mm_and_ps(_mm_loadu_ps(&model[0][0]), xyzMask);
+        __m128 c1 = _mm_and_ps(_mm_loadu_ps(&model[1][0]), xyzMask);
+        __m128 c2 = _mm_and_ps(_mm_loadu_ps(&model[2][0]), xyzMask);
+
+        float length0 = dot3(c0, c0);
+        if (isUniformScaleRigid(length0, dot3(c1, c1), dot3(c2, c2), dot3(c0, c1), dot3(c0, c2), dot3(c1, c2))) {
+            __m128 inverseScaleSquared = _mm_set1_ps(1.0f / length0);
+            storeColumn(normal, _mm_mul_ps(c0, inverseScaleSquared));
+            storeColumn(normal + 3, _mm_mul_ps(c1, inverseScaleSquared));
+            storeColumn(normal + 6, _mm_mul_ps(c2, inverseScaleSquared));
+            continue;
+        }
+
+        __m128 cross12 = cross3(c1, c2);
+        __m128 inverseDeterminant = _mm_set1_ps(1.0f / dot3(c0, cross12));
+        storeColumn(normal, _mm_mul_ps(cross12, inverseDeterminant));
+        storeColumn(normal + 3, _mm_mul_ps(cross3(c2, c0), inverseDeterminant));
+        storeColumn(normal + 6, _mm_mul_ps(cross3(c0, c1), inverseDeterminant));
+    }
+}
+
+#else
+
+// inverse transpose of the upper 3x3, for uniform scale rigid transforms this is just the matrix divided by the scale squared
+static glm::mat3 normalMatrix(const glm::mat4 &model) {
+    glm::vec3 c0(model[0]);
+    glm::vec3 c1(model[1]);
+    glm::vec3 c2(model[2]);
+
+    // M^T * M = s^2 * I, so the inverse transpose is M / s^2
+    float scaleSquared = glm::dot(c0, c0);
+    if (isUniformScaleRigid(scaleSquared, glm::dot(c1, c1), glm::dot(c2, c2), glm::dot(c0, c1), glm::dot(c0, c2), glm::dot(c1, c2))) {
+        return glm::mat3(c0, c1, c2) * (1.0f / scaleSquared);
+    }
+
+    // general case, the columns of the inverse transpose are the cofactors divided by the determinant
+    glm::vec3 cross12 = glm::cross(c1, c2);
+    float inverseDeterminant = 1.0f / glm::dot(c0, cross12);
+    return glm::mat3(cross12 * inverseDeterminant, glm::cross(c2, c0) * inverseDeterminant, glm::cross(c0, c1) * inverseDeterminant);
+}
+
+void computeNormalMatrices(InstanceData *instances, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        instances[i].normalMatrix = normalMatrix(instances[i].model);
+    }
+}
+
+#endif
@@ -0,0 +1,15 @@
+//
+// Created by kira on 17/10/2026.
+//
+
+#ifndef KIRA_SOURCE_TRANSFORM_H
+#define KIRA_SOURCE_TRANSFORM_H
+
+#include <cstddef>
+
+struct InstanceData;
+
+// fills the normal matrix of every instance from its model matrix, vectorized with SSE when available
+void computeNormalMatrices(InstanceData *instances, size_t count);
+
+#endif //KIRA_SOURCE_TRANSFORM_H